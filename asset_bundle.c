@@ -0,0 +1,177 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include"asset_bundle.h"
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+
+#define ASSET_MAX_SIDE 65535u /**< Largest side of an image accepted in a bundle */
+
+uint32_t get_asset_id(ASSET_KIND kind, int skin, int variant) {
+    return ((uint32_t) kind << 16) | ((uint32_t) skin << 8) | (uint32_t) variant;
+}
+
+/*
+ * Returns 1 if the mapped file holds a valid header, a sorted table and
+ * images inside the file.
+ */
+static int check_asset_bundle(const AssetBundle *bundle) {
+    const AssetBundleEntry *entry;
+    size_t table_end, pixels_size;
+    uint32_t i;
+    int res;
+
+    res = bundle->size >= sizeof(AssetBundleHeader) &&
+          bundle->header->magic == ASSET_BUNDLE_MAGIC &&
+          bundle->header->version == ASSET_BUNDLE_VERSION;
+
+    if (res) {
+        table_end = sizeof(AssetBundleHeader) + (size_t) bundle->header->images_count * sizeof(AssetBundleEntry);
+        res = bundle->header->images_count <= bundle->size / sizeof(AssetBundleEntry) &&
+              table_end <= bundle->size;
+    }
+
+    for (i = 0; res && i < bundle->header->images_count; i++) {
+        entry = bundle->entries + i;
+        pixels_size = (size_t) entry->width * entry->height * sizeof(uint32_t);
+
+        res = entry->width <= ASSET_MAX_SIDE && entry->height <= ASSET_MAX_SIDE &&
+              entry->offset % sizeof(uint32_t) == 0 &&
+              entry->offset >= table_end && entry->offset <= bundle->size &&
+              pixels_size <= bundle->size - entry->offset &&
+              (i == 0 || bundle->entries[i - 1].id < entry->id);
+    }
+
+    return res;
+}
+
+int open_asset_bundle(AssetBundle *bundle, const char *path) {
+    struct stat status;
+    void *data;
+    int file, res;
+
+    bundle->data = NULL;
+    bundle->size = 0;
+
+    file = open(path, O_RDONLY);
+    res = file >= 0;
+
+    if (res) {
+        res = fstat(file, &status) == 0 && status.st_size > 0;
+
+        if (res) {
+            data = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+            res = data != MAP_FAILED;
+        }
+
+        /* the mapping stays valid without the descriptor */
+        close(file);
+    }
+
+    if (res) {
+        bundle->data = (const unsigned char*) data;
+        bundle->size = (size_t) status.st_size;
+        bundle->header = (const AssetBundleHeader*) bundle->data;
+        bundle->entries = (const AssetBundleEntry*) (bundle->data + sizeof(AssetBundleHeader));
+
+        res = check_asset_bundle(bundle);
+        if (!res) {
+            fprintf(stderr, "Warining : %s is not a valid asset bundle\n", path);
+            close_asset_bundle(bundle);
+        }
+    }
+
+    return res;
+}
+
+void close_asset_bundle(AssetBundle *bundle) {
+    if (bundle->data != NULL)
+        munmap((void*) bundle->data, bundle->size);
+
+    bundle->data = NULL;
+    bundle->size = 0;
+}
+
+const uint32_t* get_asset_pixels(const AssetBundle *bundle, uint32_t id, int *width, int *height) {
+    const AssetBundleEntry *entry;
+    const uint32_t *res;
+    uint32_t low, high, middle;
+
+    res = NULL;
+    low = 0;
+    high = bundle->header->images_count;
+
+    while (low < high && res == NULL) {
+        middle = low + (high - low) / 2;
+        entry = bundle->entries + middle;
+
+        if (entry->id < id) {
+            low = middle + 1;
+        } else if (entry->id > id) {
+            high = middle;
+        } else {
+            *width = (int) entry->width;
+            *height = (int) entry->height;
+            res = (const uint32_t*) (bundle->data + entry->offset);
+        }
+    }
+
+    return res;
+}
+
+static int compare_asset_images(const void *a, const void *b) {
+    uint32_t id_a, id_b;
+
+    id_a = ((const AssetImage*) a)->id;
+    id_b = ((const AssetImage*) b)->id;
+
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+int write_asset_bundle(const char *path, int cell_size, int preview_size, AssetImage *images, int count) {
+    AssetBundleHeader header;
+    AssetBundleEntry entry;
+    FILE *file;
+    size_t offset;
+    int i, res;
+
+    qsort(images, (size_t) count, sizeof(AssetImage), compare_asset_images);
+
+    header.magic = ASSET_BUNDLE_MAGIC;
+    header.version = ASSET_BUNDLE_VERSION;
+    header.cell_size = (uint32_t) cell_size;
+    header.preview_size = (uint32_t) preview_size;
+    header.images_count = (uint32_t) count;
+
+    file = fopen(path, "wb");
+    res = file != NULL;
+
+    if (res) {
+        res = fwrite(&header, sizeof(header), 1, file) == 1;
+
+        offset = sizeof(header) + (size_t) count * sizeof(AssetBundleEntry);
+        for (i = 0; i < count && res; i++) {
+            entry.id = images[i].id;
+            entry.width = (uint32_t) images[i].width;
+            entry.height = (uint32_t) images[i].height;
+            entry.offset = (uint32_t) offset;
+
+            res = fwrite(&entry, sizeof(entry), 1, file) == 1;
+            offset += (size_t) images[i].width * images[i].height * sizeof(uint32_t);
+        }
+
+        for (i = 0; i < count && res; i++) {
+            res = fwrite(images[i].pixels, sizeof(uint32_t),
+                         (size_t) images[i].width * images[i].height, file) ==
+                  (size_t) images[i].width * images[i].height;
+        }
+
+        res = fclose(file) == 0 && res;
+    }
+
+    return res;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file asset_bundle.h
+ * @brief Binary bundle of the images of the game, baked ahead of time.
+ *
+ * The sprites are decoded, resized, rotated and mirrored once by the
+ * tools/asset_bake tool and written in a single file, so the game reads
+ * them without PNG decoding nor resizing: the file is memory-mapped and
+ * the pixels of an image are found by a binary search on its identifier.
+ *
+ * ## Layout
+ * All the numbers are uint32_t in the byte order of the machine which
+ * baked the bundle (a bundle is not meant to be shared between machines):
+ * - the AssetBundleHeader;
+ * - images_count AssetBundleEntry, sorted by identifier;
+ * - the pixels of the images, row by row, one 0xRRGGBBAA color (as
+ *   MLV_Color) per pixel.
+ *
+ * A bundle is baked for one cell size. The game draws every cell at
+ * GRID_CELL_DRAW_SIZE, a compile time constant, so no other size is ever
+ * read: it ignores a bundle whose cell size is not its own (a build with
+ * another GRID_CELL_DRAW_SIZE) and loads the PNG files.
+ *
+ * This file does not depend on MLV.
+ */
+
+#ifndef _ASSET_BUNDLE_H
+#define _ASSET_BUNDLE_H
+
+#include<stddef.h>
+#include<stdint.h>
+
+#define ASSET_BUNDLE_PATH "ressources/assets.bundle" /**< Bundle loaded by the game */
+#define ASSET_BUNDLE_MAGIC 0x424B4E53u               /**< "SNKB" read as a little endian number */
+#define ASSET_BUNDLE_VERSION 1u                      /**< Version of the layout */
+
+/**
+ * @enum ASSET_KIND
+ * @brief Kinds of images of a bundle.
+ */
+typedef enum {
+    ASSET_SNAKE_HEAD = 0,     /**< Head of a skin, variant: SPRITE_ORIENTATION */
+    ASSET_SNAKE_TAIL,         /**< Tail of a skin, variant: SPRITE_ORIENTATION */
+    ASSET_SNAKE_STRAIGHT_BODY,/**< Straight body of a skin, variant: SPRITE_ORIENTATION */
+    ASSET_SNAKE_ROTATE_BODY,  /**< Curved body of a skin, variant: SPRITE_MIRROR */
+    ASSET_SNAKE_PREVIEW,      /**< Preview of a skin in the skin dialogs */
+    ASSET_APPLE               /**< Apple at the size of a cell */
+} ASSET_KIND;
+
+/**
+ * @struct AssetBundleHeader
+ * @brief First bytes of a bundle.
+ */
+typedef struct {
+    uint32_t magic;        /**< ASSET_BUNDLE_MAGIC */
+    uint32_t version;      /**< ASSET_BUNDLE_VERSION */
+    uint32_t cell_size;    /**< Side of the cell sized images in pixels */
+    uint32_t preview_size; /**< Side of the previews in pixels */
+    uint32_t images_count; /**< Number of images */
+} AssetBundleHeader;
+
+/**
+ * @struct AssetBundleEntry
+ * @brief Position of an image in a bundle.
+ */
+typedef struct {
+    uint32_t id;     /**< Identifier, see get_asset_id() */
+    uint32_t width;  /**< Width in pixels */
+    uint32_t height; /**< Height in pixels */
+    uint32_t offset; /**< Position of the first pixel from the start of the file, in bytes */
+} AssetBundleEntry;
+
+/**
+ * @struct AssetBundle
+ * @brief Bundle mapped in memory.
+ */
+typedef struct {
+    const unsigned char *data;        /**< Mapped file */
+    size_t size;                      /**< Size of the file in bytes */
+    const AssetBundleHeader *header;  /**< Header of the file */
+    const AssetBundleEntry *entries;  /**< Table of the images */
+} AssetBundle;
+
+/**
+ * @struct AssetImage
+ * @brief Image written in a bundle.
+ */
+typedef struct {
+    uint32_t id;             /**< Identifier, see get_asset_id() */
+    int width;               /**< Width in pixels */
+    int height;              /**< Height in pixels */
+    const uint32_t *pixels;  /**< Colors, row by row */
+} AssetImage;
+
+/**
+ * @brief Returns the identifier of an image.
+ *
+ * @param[in] kind Kind of the image.
+ * @param[in] skin Index of the skin, 0 for the images without skin.
+ * @param[in] variant Orientation or mirror, 0 for the images without.
+ * @return uint32_t Identifier of the image.
+ */
+uint32_t get_asset_id(ASSET_KIND kind, int skin, int variant);
+
+/**
+ * @brief Maps a bundle in memory and checks its header and its table.
+ *
+ * Must be released with close_asset_bundle().
+ *
+ * @param[out] bundle Pointer to the bundle.
+ * @param[in] path Path of the file.
+ * @return int 1 on success, 0 if the file is missing or is not a valid bundle.
+ */
+int open_asset_bundle(AssetBundle *bundle, const char *path);
+
+/**
+ * @brief Unmaps a bundle.
+ *
+ * @param[in,out] bundle Pointer to the bundle.
+ */
+void close_asset_bundle(AssetBundle *bundle);
+
+/**
+ * @brief Finds an image of a bundle.
+ *
+ * @param[in] bundle Pointer to the bundle.
+ * @param[in] id Identifier of the image.
+ * @param[out] width Width of the image in pixels.
+ * @param[out] height Height of the image in pixels.
+ * @return const uint32_t* Colors of the image in the mapped file, NULL if
+ *         the bundle has no such image.
+ */
+const uint32_t* get_asset_pixels(const AssetBundle *bundle, uint32_t id, int *width, int *height);
+
+/**
+ * @brief Writes a bundle.
+ *
+ * @param[in] path Path of the file.
+ * @param[in] cell_size Side of the cell sized images in pixels.
+ * @param[in] preview_size Side of the previews in pixels.
+ * @param[in,out] images Images to write, sorted by identifier by the function.
+ * @param[in] count Number of images.
+ * @return int 1 on success, 0 if the file could not be written.
+ */
+int write_asset_bundle(const char *path, int cell_size, int preview_size, AssetImage *images, int count);
+
+#endif /* _ASSET_BUNDLE_H */
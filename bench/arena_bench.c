@@ -0,0 +1,68 @@
+/**
+ * @file arena_bench.c
+ * @brief Measures the simulation speed of an arena game with K bots.
+ *
+ * For every number of snakes K, an arena game of K bots is played
+ * headless on a BENCH_GRID_SIZE x BENCH_GRID_SIZE grid and the number of
+ * ticks per second is printed. Since collisions are found in the
+ * occupancy grid, the cost of one snake move should stay flat as K grows.
+ *
+ * Usage: ./arena_bench [ticks]
+ */
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<time.h>
+
+#include"game_config.h"
+#include"game_update.h"
+
+#define BENCH_GRID_SIZE 200    /**< Width and height of the benchmark grid */
+#define BENCH_WARMUP_TICKS 100 /**< Ticks played before the measure */
+#define BENCH_DEFAULT_TICKS 2000
+#define BENCH_SEED 1234
+
+int main(int argc, char **argv) {
+    const int snakes_counts[] = { 8, 16, 32, 64, 128, 256 };
+    GameConfig config;
+    clock_t start, end;
+    double seconds;
+    long ticks, t;
+    int i, k;
+
+    ticks = argc > 1 ? atol(argv[1]) : BENCH_DEFAULT_TICKS;
+    if (ticks <= 0)
+        ticks = BENCH_DEFAULT_TICKS;
+
+    printf("grid %dx%d, %ld ticks\n", BENCH_GRID_SIZE, BENCH_GRID_SIZE, ticks);
+    printf("%8s %14s %18s\n", "snakes", "ticks/s", "ns/snake move");
+
+    for (i = 0; i < (int) (sizeof(snakes_counts) / sizeof(snakes_counts[0])); i++) {
+        k = snakes_counts[i];
+
+        if (!init_arena_game(&config, 0, k, BENCH_GRID_SIZE, BENCH_GRID_SIZE, BENCH_SEED)) {
+            fprintf(stderr, "Error arena_bench: can't start a game with %d snakes\n", k);
+            exit(EXIT_FAILURE);
+        }
+
+        for (t = 0; t < BENCH_WARMUP_TICKS; t++)
+            update_game(&config);
+
+        start = clock();
+        for (t = 0; t < ticks; t++)
+            update_game(&config);
+        end = clock();
+
+        seconds = (double) (end - start) / CLOCKS_PER_SEC;
+        if (seconds <= 0)
+            seconds = 1.0 / CLOCKS_PER_SEC;
+
+        printf("%8d %14.0f %18.1f\n", k,
+               ticks / seconds,
+               seconds * 1e9 / ((double) ticks * k));
+
+        free_game(&config);
+    }
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file batch_bench.c
+ * @brief Plays a batch of headless games with 1 to N threads.
+ *
+ * The same batch (same seeds, so the same games) is played with every
+ * number of worker threads from 1 to N, the number of online cores by
+ * default. For each run the wall time, the aggregate ticks per second,
+ * the speed-up over one thread and the efficiency (speed-up per thread,
+ * 1 for a linear scaling) are printed, then the results of the games.
+ *
+ * Usage: ./batch_bench [games] [max threads] [max ticks]
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<time.h>
+#include<unistd.h>
+
+#include"game_batch.h"
+
+#define BENCH_DEFAULT_GAMES 2000
+#define BENCH_DEFAULT_TICKS 5000
+#define BENCH_GRID_SIZE 32     /**< Width and height of the grid of every game */
+#define BENCH_BOTS 3           /**< Bots playing against the player of every game */
+#define BENCH_SEED 1234
+
+/*
+ * Returns the monotonic time in seconds.
+ */
+static double get_seconds(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/*
+ * Plays the batch with a number of threads and prints one line of the table.
+ * base is the wall time of the run with one thread (set by that run).
+ */
+static void run_batch_bench(GameBatchSettings *settings, int games, int threads,
+                            double *base, GameBatchStats *stats) {
+    GameBatch batch;
+    double start, seconds;
+
+    if (!init_game_batch(&batch, games, settings)) {
+        fprintf(stderr, "Error batch_bench: can't allocate %d games\n", games);
+        exit(EXIT_FAILURE);
+    }
+
+    start = get_seconds();
+    if (!run_game_batch(&batch, threads)) {
+        fprintf(stderr, "Error batch_bench: can't start %d threads\n", threads);
+        exit(EXIT_FAILURE);
+    }
+    seconds = get_seconds() - start;
+    if (seconds <= 0)
+        seconds = 1e-9;
+
+    get_game_batch_stats(&batch, stats);
+    if (threads == 1)
+        *base = seconds;
+
+    printf("%8d %10.3f %14.0f %10.2f %10.2f %8lu\n", threads, seconds,
+           stats->total_ticks / seconds, *base / seconds, *base / seconds / threads, batch.steals);
+
+    free_game_batch(&batch);
+}
+
+int main(int argc, char **argv) {
+    GameBatchSettings settings;
+    GameBatchStats stats;
+    double base;
+    int games, max_threads, threads;
+
+    games = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_GAMES;
+    if (games <= 0)
+        games = BENCH_DEFAULT_GAMES;
+
+    max_threads = argc > 2 ? atoi(argv[2]) : (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (max_threads <= 0)
+        max_threads = 1;
+    else if (max_threads > BATCH_MAX_THREADS)
+        max_threads = BATCH_MAX_THREADS;
+
+    settings.players = 1;
+    settings.bots = BENCH_BOTS;
+    settings.width = BENCH_GRID_SIZE;
+    settings.height = BENCH_GRID_SIZE;
+    settings.max_ticks = argc > 3 ? (unsigned long) atol(argv[3]) : BENCH_DEFAULT_TICKS;
+    settings.seed = BENCH_SEED;
+
+    printf("%d games, grid %dx%d, 1 player and %d bots, at most %lu ticks\n",
+           games, BENCH_GRID_SIZE, BENCH_GRID_SIZE, BENCH_BOTS, settings.max_ticks);
+    printf("%8s %10s %14s %10s %10s %8s\n", "threads", "seconds", "ticks/s", "speed-up", "efficiency", "steals");
+
+    base = 0;
+
+    for (threads = 1; threads <= max_threads; threads++)
+        run_batch_bench(&settings, games, threads, &base, &stats);
+
+    printf("games: %d over, %d won, %d timeout, %d failed\n",
+           stats.over, stats.won, stats.timeout, stats.failed);
+    printf("length: mean %.1f ticks, max %lu ticks\n", stats.mean_ticks, stats.max_ticks);
+    printf("score: mean %.1f, max %u\n", stats.mean_score, stats.max_score);
+
+    exit(EXIT_SUCCESS);
+}
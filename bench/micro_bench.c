@@ -0,0 +1,392 @@
+/**
+ * @file micro_bench.c
+ * @brief Times the hot functions of the simulation at several board fill ratios.
+ *
+ * The board is a BENCH_GRID_SIZE x BENCH_GRID_SIZE single player game
+ * whose snake covers 10%, 50%, 90% and 99% of the cells. The snake is
+ * laid along a Hamiltonian cycle of the grid and follows it when it
+ * moves, so it never collides with itself and keeps its fill ratio for
+ * as long as the test runs.
+ *
+ * Every test is run BENCH_DEFAULT_RUNS times (after one warm-up run),
+ * each run on a board set up again. The output is CSV, one line per test and fill
+ * ratio: the mean time per operation over the runs, its standard
+ * deviation, the fastest and the slowest run, in nanoseconds.
+ *
+ * The "_scan" tests run the same function on a snake detached from the
+ * occupancy grid, which falls back to walking the ring buffer of the
+ * snake. "move_and_expand_snake" removes the tail after each move so the
+ * fill ratio stays the same. "update_game" is one whole tick of the game,
+ * the player turning along the cycle through its turn queue and losing
+ * its tail again when it eats the apple.
+ *
+ * Usage: ./micro_bench [operations] [runs]
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<math.h>
+#include<time.h>
+
+#include"game_config.h"
+#include"game_update.h"
+
+#define BENCH_GRID_SIZE 30            /**< Width and height of the grid, even for the Hamiltonian cycle */
+#define BENCH_AREA ( BENCH_GRID_SIZE * BENCH_GRID_SIZE )
+#define BENCH_DEFAULT_OPERATIONS 1000000
+#define BENCH_DEFAULT_RUNS 10
+#define BENCH_MAX_RUNS 100
+#define BENCH_SEED 1234
+
+/**
+ * @struct MicroBoard
+ * @brief Game of a test and the cycle its first snake follows.
+ */
+typedef struct {
+    GameConfig config;
+    vector2i cycle[BENCH_AREA];          /**< Cells of the Hamiltonian cycle, in order */
+    SnakeDirection next[BENCH_AREA];     /**< Direction from each cell (y * width + x) to the next one of the cycle */
+    int fill;                            /**< Cells covered by the first snake */
+} MicroBoard;
+
+/**
+ * @struct MicroBench
+ * @brief One test: the function timed and the cost of one of its operations.
+ */
+typedef struct {
+    const char *name;
+    GAME_MODE game_mode;                 /**< GAME_TWO_PLAYER_MODE when a second snake is needed */
+    int detached;                        /**< 1 if the snakes are detached from the occupancy grid */
+    int divisor;                         /**< Operations of a run divided by this (slow tests) */
+    void (*run)(MicroBoard *board, long operations);
+} MicroBench;
+
+static MicroBoard micro_board;
+static volatile long bench_sink; /* keeps the results of the timed calls alive */
+
+/*
+ * Returns the monotonic time in seconds.
+ */
+static double get_seconds(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static SnakeDirection get_step_direction(vector2i from, vector2i to) {
+    SnakeDirection res;
+
+    if (to.x > from.x)
+        res = SNAKE_DIRECTION_RIGTH;
+    else if (to.x < from.x)
+        res = SNAKE_DIRECTION_LEFT;
+    else if (to.y > from.y)
+        res = SNAKE_DIRECTION_BOTTOM;
+    else
+        res = SNAKE_DIRECTION_TOP;
+
+    return res;
+}
+
+/*
+ * Builds the Hamiltonian cycle: along the first row, then back and forth
+ * over the other rows without the first column, then up the first column.
+ */
+static void init_micro_cycle(MicroBoard *board) {
+    vector2i *cell;
+    int i, x, y;
+
+    cell = board->cycle;
+
+    for (x = 0; x < BENCH_GRID_SIZE; x++)
+        *cell++ = create_vector2i(x, 0);
+
+    for (y = 1; y < BENCH_GRID_SIZE; y++) {
+        for (i = 1; i < BENCH_GRID_SIZE; i++)
+            *cell++ = create_vector2i(y % 2 == 1 ? BENCH_GRID_SIZE - i : i, y);
+    }
+
+    for (y = BENCH_GRID_SIZE - 1; y > 0; y--)
+        *cell++ = create_vector2i(0, y);
+
+    for (i = 0; i < BENCH_AREA; i++) {
+        cell = &board->cycle[i];
+        board->next[cell->y * BENCH_GRID_SIZE + cell->x] =
+            get_step_direction(*cell, board->cycle[(i + 1) % BENCH_AREA]);
+    }
+}
+
+/*
+ * Returns the direction the first snake must take to stay on the cycle.
+ */
+static SnakeDirection get_micro_direction(MicroBoard *board) {
+    vector2i *head;
+
+    head = get_snake_head_position(&board->config.snakes[0]);
+
+    return board->next[head->y * BENCH_GRID_SIZE + head->x];
+}
+
+/*
+ * Starts a game whose first snake covers `fill` cells of the cycle, its
+ * head at the cell `fill - 1`. The second snake, if any, has one segment
+ * on the last cell of the cycle. The only object is an apple.
+ */
+static void setup_micro_board(MicroBoard *board, const MicroBench *bench, int fill) {
+    GameConfig *config;
+    Snake *snake;
+    int i;
+
+    config = &board->config;
+    board->fill = fill;
+
+    if (!init_game(config, bench->game_mode, BENCH_GRID_SIZE, BENCH_GRID_SIZE, BENCH_SEED)) {
+        fprintf(stderr, "Error micro_bench: can't start a game\n");
+        exit(EXIT_FAILURE);
+    }
+
+    snake = &config->snakes[0];
+    *snake = create_snake(snake->items, snake->capacity);
+
+    for (i = 0; i < fill; i++)
+        snake->items[i] = board->cycle[fill - 1 - i];
+
+    snake->count = (size_t) fill;
+    snake->moves = (unsigned long) fill;
+    snake->direction = get_step_direction(board->cycle[fill - 2], board->cycle[fill - 1]);
+    snake->to_rotate = snake->direction;
+
+    if (bench->game_mode == GAME_TWO_PLAYER_MODE) {
+        snake = &config->snakes[1];
+        *snake = create_snake(snake->items, snake->capacity);
+        snake->items[0] = board->cycle[BENCH_AREA - 1];
+    }
+
+    for (i = 0; i < GAME_OBJECTS_NUMBER; i++) {
+        config->objects[i].type = GAME_OBJECT_NONE;
+        config->objects[i].pos = create_vector2i(-1, -1);
+    }
+    config->objects[0].type = GAME_OBJECT_APPLE;
+
+    rebuild_occupancy_grid(config);
+    place_game_object(config, &config->objects[0]);
+
+    if (bench->detached) {
+        for (i = 0; i < config->snakes_count; i++)
+            detach_snake_from_grid(&config->snakes[i]);
+    }
+}
+
+static void run_move_snake(MicroBoard *board, long operations) {
+    Snake *snake;
+    long k;
+
+    snake = &board->config.snakes[0];
+
+    for (k = 0; k < operations; k++) {
+        snake->to_rotate = get_micro_direction(board);
+        move_snake(snake);
+    }
+}
+
+static void run_move_and_expand_snake(MicroBoard *board, long operations) {
+    Snake *snake;
+    long k;
+
+    snake = &board->config.snakes[0];
+
+    for (k = 0; k < operations; k++) {
+        snake->to_rotate = get_micro_direction(board);
+        move_and_expand_snake(snake);
+        remove_tail_snake(snake);
+    }
+}
+
+static void run_get_snake_part_position(MicroBoard *board, long operations) {
+    Snake *snake;
+    size_t index;
+    long k, sum;
+
+    snake = &board->config.snakes[0];
+    index = 0;
+    sum = 0;
+
+    for (k = 0; k < operations; k++) {
+        sum += get_snake_part_position(snake, index)->x;
+
+        index++;
+        if (index == snake->count)
+            index = 0;
+    }
+
+    bench_sink = sum;
+}
+
+static void run_find_snake_part_by_position(MicroBoard *board, long operations) {
+    Snake *snake;
+    long k, sum;
+    int cell;
+
+    snake = &board->config.snakes[0];
+    cell = 0;
+    sum = 0;
+
+    /* every cell of the board in turn: the hits and the misses */
+    for (k = 0; k < operations; k++) {
+        sum += find_snake_part_by_position(snake, board->cycle[cell]);
+
+        cell++;
+        if (cell == BENCH_AREA)
+            cell = 0;
+    }
+
+    bench_sink = sum;
+}
+
+static void run_check_self_snake_colision(MicroBoard *board, long operations) {
+    Snake *snake;
+    long k, sum;
+
+    snake = &board->config.snakes[0];
+    sum = 0;
+
+    for (k = 0; k < operations; k++) {
+        check_self_snake_colision(snake);
+        sum += snake->is_alive;
+    }
+
+    bench_sink = sum;
+}
+
+static void run_check_snake_colision(MicroBoard *board, long operations) {
+    Snake *snakes;
+    long k, sum;
+
+    snakes = board->config.snakes;
+    sum = 0;
+
+    /* the head of the short snake against the body of the long one */
+    for (k = 0; k < operations; k++) {
+        check_snake_colision(&snakes[1], &snakes[0]);
+        sum += snakes[1].is_alive;
+    }
+
+    bench_sink = sum;
+}
+
+static void run_place_game_object(MicroBoard *board, long operations) {
+    long k, sum;
+
+    sum = 0;
+
+    for (k = 0; k < operations; k++)
+        sum += place_game_object(&board->config, &board->config.objects[0]);
+
+    bench_sink = sum;
+}
+
+static void run_update_game(MicroBoard *board, long operations) {
+    GameConfig *config;
+    long k;
+
+    config = &board->config;
+
+    for (k = 0; k < operations; k++) {
+        queue_snake_turn(&config->snakes[0], get_micro_direction(board), (unsigned long) k);
+        update_game(config);
+
+        /* an eaten apple does not change the fill ratio */
+        if (get_snake_size(&config->snakes[0]) > (size_t) board->fill)
+            remove_tail_snake(&config->snakes[0]);
+    }
+
+    if (!config->snakes[0].is_alive) {
+        fprintf(stderr, "Error micro_bench: the snake left the cycle\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static const MicroBench micro_benches[] = {
+    { "move_snake",                        GAME_SINGLE_PLAYER_MODE, 0, 1,   run_move_snake },
+    { "move_and_expand_snake",             GAME_SINGLE_PLAYER_MODE, 0, 1,   run_move_and_expand_snake },
+    { "get_snake_part_position",           GAME_SINGLE_PLAYER_MODE, 0, 1,   run_get_snake_part_position },
+    { "find_snake_part_by_position",       GAME_SINGLE_PLAYER_MODE, 0, 1,   run_find_snake_part_by_position },
+    { "find_snake_part_by_position_scan",  GAME_SINGLE_PLAYER_MODE, 1, 100, run_find_snake_part_by_position },
+    { "check_self_snake_colision",         GAME_SINGLE_PLAYER_MODE, 0, 1,   run_check_self_snake_colision },
+    { "check_self_snake_colision_scan",    GAME_SINGLE_PLAYER_MODE, 1, 100, run_check_self_snake_colision },
+    { "check_snake_colision",              GAME_TWO_PLAYER_MODE,    0, 1,   run_check_snake_colision },
+    { "check_snake_colision_scan",         GAME_TWO_PLAYER_MODE,    1, 100, run_check_snake_colision },
+    { "place_game_object",                 GAME_SINGLE_PLAYER_MODE, 0, 1,   run_place_game_object },
+    { "update_game",                       GAME_SINGLE_PLAYER_MODE, 0, 10,  run_update_game }
+};
+
+int main(int argc, char **argv) {
+    const int fill_ratios[] = { 10, 50, 90, 99 };
+    const MicroBench *bench;
+    double times[BENCH_MAX_RUNS];
+    double start, mean, variance, min, max;
+    long operations, bench_operations;
+    int runs, i, j, r, fill;
+
+    operations = argc > 1 ? atol(argv[1]) : BENCH_DEFAULT_OPERATIONS;
+    if (operations <= 0)
+        operations = BENCH_DEFAULT_OPERATIONS;
+
+    runs = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_RUNS;
+    if (runs <= 1 || runs > BENCH_MAX_RUNS)
+        runs = BENCH_DEFAULT_RUNS;
+
+    init_micro_cycle(&micro_board);
+
+    printf("benchmark,fill_percent,operations,runs,mean_ns,stddev_ns,min_ns,max_ns\n");
+
+    for (i = 0; i < (int) (sizeof(micro_benches) / sizeof(micro_benches[0])); i++) {
+        bench = &micro_benches[i];
+
+        bench_operations = operations / bench->divisor;
+        if (bench_operations < 1)
+            bench_operations = 1;
+
+        for (j = 0; j < (int) (sizeof(fill_ratios) / sizeof(fill_ratios[0])); j++) {
+            fill = BENCH_AREA * fill_ratios[j] / 100;
+
+            /* run -1 warms the caches up and is not counted */
+            for (r = -1; r < runs; r++) {
+                setup_micro_board(&micro_board, bench, fill);
+
+                start = get_seconds();
+                bench->run(&micro_board, bench_operations);
+                if (r >= 0)
+                    times[r] = (get_seconds() - start) * 1e9 / bench_operations;
+
+                free_game(&micro_board.config);
+            }
+
+            mean = 0;
+            min = times[0];
+            max = times[0];
+            for (r = 0; r < runs; r++) {
+                mean += times[r];
+                if (times[r] < min)
+                    min = times[r];
+                if (times[r] > max)
+                    max = times[r];
+            }
+            mean /= runs;
+
+            variance = 0;
+            for (r = 0; r < runs; r++)
+                variance += (times[r] - mean) * (times[r] - mean);
+            variance /= runs - 1;
+
+            printf("%s,%d,%ld,%d,%.2f,%.2f,%.2f,%.2f\n", bench->name, fill_ratios[j],
+                   bench_operations, runs, mean, sqrt(variance), min, max);
+        }
+    }
+
+    exit(EXIT_SUCCESS);
+}
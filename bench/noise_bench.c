@@ -0,0 +1,326 @@
+/**
+ * @file noise_bench.c
+ * @brief Measures the computation of the menu background noise.
+ *
+ * Three ways of computing the colors of the 1280x720 background made of
+ * 10 pixels tiles are timed over the same frames:
+ * - the previous path: one noise() per tile, four hashes of sin and fmod
+ *   in double precision each;
+ * - compute_noise_rows_scalar();
+ * - compute_noise_rows() (SSE2 when available).
+ * The colors of the last two are compared bit for bit on every frame.
+ * Only the computation is measured, not the upload to the window.
+ *
+ * Then frames are paced at BENCH_FRAMERATE through a NoisePipeline with
+ * and without worker threads, for smaller and smaller tiles. As in the
+ * menu, the tiles are painted in two 32 bits images, one per field of
+ * the pipeline. The time spent by the main thread in
+ * finish_noise_frame() and start_noise_frame() is printed, the rest of
+ * a frame is slept as if the image was presented. The colors and the
+ * images of the pipeline are checked against compute_noise_frame() and
+ * paint_noise_rows().
+ *
+ * Usage: ./noise_bench [frames] [threads]
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<string.h>
+#include<math.h>
+#include<time.h>
+#include<unistd.h>
+
+#include"noise_pipeline.h"
+
+#define BENCH_WIDTH 1280
+#define BENCH_HEIGHT 720
+#define BENCH_TILE 10
+#define BENCH_DEFAULT_FRAMES 500
+#define BENCH_FRAME_TIME 0.016f /**< Animation time between two frames, in seconds */
+#define BENCH_FRAMERATE 120L    /**< Frames per second of the pipeline runs */
+#define BENCH_PIPELINE_FRAMES 240
+#define BENCH_SEC_IN_NSEC 1000000000L
+
+/*
+ * Previous hash of the menu background.
+ */
+static float legacy_hash(float n) {
+    return (float)fmod(sin(n) * 43758.5453123, 1.0);
+}
+
+/*
+ * Previous noise of the menu background.
+ */
+static float legacy_noise(float x, float y, float t) {
+    float fx, fy, a, b, c, d, u, v, lerp1, lerp2;
+
+    fx = (float)floor(x);
+    fy = (float)floor(y);
+
+    a = legacy_hash(fx + fy * 57.0f + t * 13.0f);
+    b = legacy_hash(fx + 1.0f + fy * 57.0f + t * 13.0f);
+    c = legacy_hash(fx + (fy + 1.0f) * 57.0f + t * 13.0f);
+    d = legacy_hash(fx + 1.0f + (fy + 1.0f) * 57.0f + t * 13.0f);
+
+    u = x - fx;
+    v = y - fy;
+
+    lerp1 = a + u * (b - a);
+    lerp2 = c + u * (d - c);
+
+    return lerp1 + v * (lerp2 - lerp1);
+}
+
+/*
+ * Previous path: the color of every tile computed on its own.
+ */
+static void compute_legacy_rows(NoiseField *field, const NoiseShade *shade, float time_s) {
+    float n, r, g, b;
+    int i, j;
+
+    for (j = 0; j < field->rows; j++) {
+        for (i = 0; i < field->columns; i++) {
+            n = legacy_noise(i * field->tile * 0.1f, j * field->tile * 0.1f, time_s * 0.15f);
+
+            r = shade->r * (shade->min_shade + n * (shade->max_shade - shade->min_shade));
+            g = shade->g * (shade->min_shade + n * (shade->max_shade - shade->min_shade));
+            b = shade->b * (shade->min_shade + n * (shade->max_shade - shade->min_shade));
+
+            field->colors[j * field->columns + i] =
+                ((uint32_t) r << 24) | ((uint32_t) g << 16) | ((uint32_t) b << 8) | 255u;
+        }
+    }
+}
+
+/*
+ * Returns the difference between two times in milliseconds.
+ */
+static double get_milliseconds(const struct timespec *from, const struct timespec *to) {
+    return (to->tv_sec - from->tv_sec) * 1e3 + (to->tv_nsec - from->tv_nsec) / 1e6;
+}
+
+/*
+ * Parameters of the frame f of the pipeline runs.
+ */
+static void get_bench_frame(NoiseFrame *frame, const NoiseShade *shade, int split_row, long f) {
+    frame->top = *shade;
+    frame->bottom = *shade;
+    frame->top.min_shade = 180.f;
+    frame->split_row = split_row;
+    frame->time_s = f * BENCH_FRAME_TIME;
+}
+
+/*
+ * Target of a BENCH_WIDTH x BENCH_HEIGHT image, in the ARGB order of the
+ * window surfaces on x86.
+ */
+static void init_bench_target(NoiseTarget *target, uint32_t *pixels) {
+    target->pixels = pixels;
+    target->pitch = BENCH_WIDTH;
+
+    target->shifts[0] = 16;
+    target->shifts[1] = 8;
+    target->shifts[2] = 0;
+    target->shifts[3] = 24;
+    target->masks[0] = 0x00FF0000u;
+    target->masks[1] = 0x0000FF00u;
+    target->masks[2] = 0x000000FFu;
+    target->masks[3] = 0xFF000000u;
+}
+
+/*
+ * Plays paced frames with a pipeline and prints one line of the table.
+ * Returns the number of frames whose colors or image differ from
+ * compute_noise_frame() and paint_noise_rows().
+ */
+static long run_pipeline_bench(const NoiseShade *shade, int tile, int threads) {
+    NoisePipeline pipeline;
+    NoiseField expected;
+    NoiseFrame frame;
+    NoiseField *field;
+    NoiseTarget targets[3];
+    uint32_t *images[3];
+    struct timespec deadline, start, end, cpu_start, cpu_end;
+    double wall, cpu, worst, ms;
+    long f, mismatches;
+    size_t size, image_size;
+    int i, index;
+
+    image_size = (size_t) BENCH_WIDTH * BENCH_HEIGHT * sizeof(uint32_t);
+    for (i = 0; i < 3; i++)
+        images[i] = (uint32_t*) malloc(image_size);
+
+    if (images[0] == NULL || images[1] == NULL || images[2] == NULL ||
+        !init_noise_pipeline(&pipeline, BENCH_WIDTH, BENCH_HEIGHT, tile, threads) ||
+        !init_noise_field(&expected, BENCH_WIDTH, BENCH_HEIGHT, tile)) {
+        fprintf(stderr, "Error noise_bench: can't allocate the pipeline\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* images of the two fields, then the expected one */
+    for (i = 0; i < 3; i++)
+        init_bench_target(&targets[i], images[i]);
+    set_noise_pipeline_target(&pipeline, 0, &targets[0]);
+    set_noise_pipeline_target(&pipeline, 1, &targets[1]);
+
+    wall = 0;
+    worst = 0;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+
+    for (f = 0; f < BENCH_PIPELINE_FRAMES; f++) {
+        get_bench_frame(&frame, shade, pipeline.fields[0].rows / 6, f);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        finish_noise_frame(&pipeline);
+        start_noise_frame(&pipeline, &frame);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        ms = get_milliseconds(&start, &end);
+        wall += ms;
+        if (ms > worst)
+            worst = ms;
+
+        /* presentation of the frame */
+        deadline.tv_nsec += BENCH_SEC_IN_NSEC / BENCH_FRAMERATE;
+        if (deadline.tv_nsec >= BENCH_SEC_IN_NSEC) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= BENCH_SEC_IN_NSEC;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+    }
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+    cpu = get_milliseconds(&cpu_start, &cpu_end);
+
+    printf("%6d %10dx%-4d %8d %12.3f %12.3f %10.3f\n", tile, pipeline.fields[0].columns,
+           pipeline.fields[0].rows, pipeline.threads_count, wall / BENCH_PIPELINE_FRAMES,
+           cpu / BENCH_PIPELINE_FRAMES, worst);
+
+    size = expected.columns * expected.rows * sizeof(uint32_t);
+    mismatches = 0;
+    for (f = 0; f < BENCH_PIPELINE_FRAMES; f++) {
+        get_bench_frame(&frame, shade, expected.rows / 6, f);
+        start_noise_frame(&pipeline, &frame);
+
+        field = finish_noise_frame(&pipeline);
+        index = (int) (field - pipeline.fields);
+
+        compute_noise_frame(&expected, &frame, 0, expected.rows);
+        paint_noise_rows(&expected, &targets[2], 0, expected.rows);
+        mismatches += memcmp(field->colors, expected.colors, size) != 0 ||
+                       memcmp(images[index], images[2], image_size) != 0;
+    }
+
+    free_noise_field(&expected);
+    free_noise_pipeline(&pipeline);
+    for (i = 0; i < 3; i++)
+        free(images[i]);
+
+    return mismatches;
+}
+
+/*
+ * Prints the time of one way of computing the frames.
+ */
+static void print_noise_bench(const char *name, clock_t start, clock_t end, long frames, double base) {
+    double seconds;
+
+    seconds = (double) (end - start) / CLOCKS_PER_SEC;
+    if (seconds <= 0)
+        seconds = 1.0 / CLOCKS_PER_SEC;
+
+    printf("%-10s %12.3f %12.0f %10.2f\n", name, seconds * 1000 / frames,
+           frames / seconds, base > 0 ? base / seconds : 1.0);
+}
+
+int main(int argc, char **argv) {
+    const int tiles[] = { 10, 5, 2, 1 };
+    NoiseField legacy, scalar, simd;
+    NoiseShade shade;
+    clock_t start, end;
+    double base;
+    long frames, f, mismatches;
+    int threads, i;
+    size_t size;
+
+    frames = argc > 1 ? atol(argv[1]) : BENCH_DEFAULT_FRAMES;
+    if (frames <= 0)
+        frames = BENCH_DEFAULT_FRAMES;
+
+    /* the main thread is one of the workers of a frame */
+    threads = argc > 2 ? atoi(argv[2]) : (int) sysconf(_SC_NPROCESSORS_ONLN) - 1;
+    if (threads < 0)
+        threads = 0;
+    else if (threads > NOISE_PIPELINE_MAX_THREADS)
+        threads = NOISE_PIPELINE_MAX_THREADS;
+
+    if (!init_noise_field(&legacy, BENCH_WIDTH, BENCH_HEIGHT, BENCH_TILE) ||
+        !init_noise_field(&scalar, BENCH_WIDTH, BENCH_HEIGHT, BENCH_TILE) ||
+        !init_noise_field(&simd, BENCH_WIDTH, BENCH_HEIGHT, BENCH_TILE)) {
+        fprintf(stderr, "Error noise_bench: can't allocate the fields\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* purple of the default palette */
+    shade.r = 0.20f;
+    shade.g = 0.45f;
+    shade.b = 1.00f;
+    shade.min_shade = 185.f;
+    shade.max_shade = 255.f;
+
+    size = scalar.columns * scalar.rows * sizeof(uint32_t);
+
+    printf("%dx%d pixels, %dx%d tiles, %ld frames, SSE2 %s\n", BENCH_WIDTH, BENCH_HEIGHT,
+           scalar.columns, scalar.rows, frames, NOISE_FIELD_SIMD ? "on" : "off");
+    printf("%-10s %12s %12s %10s\n", "path", "ms/frame", "frames/s", "speed-up");
+
+    start = clock();
+    for (f = 0; f < frames; f++)
+        compute_legacy_rows(&legacy, &shade, f * BENCH_FRAME_TIME);
+    end = clock();
+    base = (double) (end - start) / CLOCKS_PER_SEC;
+    print_noise_bench("sin/fmod", start, end, frames, 0);
+
+    start = clock();
+    for (f = 0; f < frames; f++)
+        compute_noise_rows_scalar(&scalar, 0, scalar.rows, &shade, f * BENCH_FRAME_TIME);
+    end = clock();
+    print_noise_bench("scalar", start, end, frames, base);
+
+    start = clock();
+    for (f = 0; f < frames; f++)
+        compute_noise_rows(&simd, 0, simd.rows, &shade, f * BENCH_FRAME_TIME);
+    end = clock();
+    print_noise_bench("simd", start, end, frames, base);
+
+    /* same frames again, compared one by one */
+    mismatches = 0;
+    for (f = 0; f < frames; f++) {
+        compute_noise_rows_scalar(&scalar, 0, scalar.rows, &shade, f * BENCH_FRAME_TIME);
+        compute_noise_rows(&simd, 0, simd.rows, &shade, f * BENCH_FRAME_TIME);
+        mismatches += memcmp(scalar.colors, simd.colors, size) != 0;
+    }
+    printf("simd and scalar colors: %s (%ld frames differ)\n",
+           mismatches == 0 ? "identical" : "DIFFERENT", mismatches);
+
+    printf("\npipeline, %d frames at %ld frames/s (%.3f ms per frame)\n",
+           BENCH_PIPELINE_FRAMES, BENCH_FRAMERATE, 1e3 / BENCH_FRAMERATE);
+    printf("%6s %15s %8s %12s %12s %10s\n", "tile", "tiles", "threads",
+           "main ms", "main cpu ms", "worst ms");
+
+    for (i = 0; i < (int) (sizeof(tiles) / sizeof(tiles[0])); i++) {
+        mismatches += run_pipeline_bench(&shade, tiles[i], 0);
+        if (threads > 0)
+            mismatches += run_pipeline_bench(&shade, tiles[i], threads);
+    }
+    printf("pipeline colors and images: %s\n", mismatches == 0 ? "identical" : "DIFFERENT");
+
+    free_noise_field(&legacy);
+    free_noise_field(&scalar);
+    free_noise_field(&simd);
+
+    exit(mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,112 @@
+#include"font_registry.h"
+#include"text_cache.h"
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<string.h>
+
+typedef struct {
+    char path[FONT_PATH_MAX_SIZE];
+    int size;
+    MLV_Font *font;        /* NULL if the entry is free */
+    int references;
+    unsigned long last_use;
+} FontEntry;
+
+typedef struct {
+    FontEntry entries[FONT_REGISTRY_SIZE];
+    unsigned long clock;   /* incremented at every acquire */
+    unsigned long hits;
+    unsigned long loads;
+    unsigned long evictions;
+} FontRegistry;
+
+static FontRegistry font_registry;
+
+static void free_font_entry(FontEntry *entry) {
+    if (entry->font != NULL) {
+        forget_font_texts(entry->font);
+        MLV_free_font(entry->font);
+        entry->font = NULL;
+    }
+}
+
+MLV_Font* acquire_font(const char *path, int size) {
+    FontEntry *entry, *victim;
+    int i;
+
+    if (strlen(path) >= FONT_PATH_MAX_SIZE) {
+        fprintf(stderr, "Error : font path %s too long\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    font_registry.clock++;
+
+    entry = NULL;
+    victim = NULL;
+
+    /* the free entry, or else the least recently used unused font, is the victim */
+    for (i = 0; i < FONT_REGISTRY_SIZE && entry == NULL; i++) {
+        if (font_registry.entries[i].font == NULL) {
+            if (victim == NULL || victim->font != NULL)
+                victim = &font_registry.entries[i];
+        } else if (font_registry.entries[i].size == size && strcmp(font_registry.entries[i].path, path) == 0) {
+            entry = &font_registry.entries[i];
+        } else if (font_registry.entries[i].references == 0 &&
+                   (victim == NULL || (victim->font != NULL &&
+                                       font_registry.entries[i].last_use < victim->last_use))) {
+            victim = &font_registry.entries[i];
+        }
+    }
+
+    if (entry != NULL) {
+        font_registry.hits++;
+    } else {
+        if (victim == NULL) {
+            fprintf(stderr, "Error : more than %d fonts used at once\n", FONT_REGISTRY_SIZE);
+            exit(EXIT_FAILURE);
+        }
+
+        if (victim->font != NULL)
+            font_registry.evictions++;
+        free_font_entry(victim);
+
+        entry = victim;
+        entry->font = MLV_load_font(path, size);
+        if (entry->font == NULL) {
+            fprintf(stderr, "Error : font %s not found\n", path);
+            exit(EXIT_FAILURE);
+        }
+
+        strcpy(entry->path, path);
+        entry->size = size;
+        entry->references = 0;
+        font_registry.loads++;
+    }
+
+    entry->references++;
+    entry->last_use = font_registry.clock;
+
+    return entry->font;
+}
+
+void release_font(MLV_Font *font) {
+    int i;
+
+    for (i = 0; i < FONT_REGISTRY_SIZE; i++) {
+        if (font_registry.entries[i].font == font && font != NULL)
+            font_registry.entries[i].references--;
+    }
+}
+
+void free_font_registry() {
+    int i;
+
+    for (i = 0; i < FONT_REGISTRY_SIZE; i++)
+        free_font_entry(&font_registry.entries[i]);
+}
+
+void print_font_registry_report() {
+    printf("font registry: %lu hits, %lu loads, %lu evictions\n",
+           font_registry.hits, font_registry.loads, font_registry.evictions);
+}
@@ -0,0 +1,54 @@
+/**
+ * @file font_registry.h
+ * @brief Registry of the loaded fonts, shared by the buttons and the menus.
+ *
+ * Loading a TTF font reads the file and sets up its glyphs. A font is
+ * loaded once for a (path, size) pair and then shared: acquire_font()
+ * returns the font already loaded and counts one more reference,
+ * release_font() counts one less.
+ *
+ * A font without reference stays loaded, so opening a menu again loads
+ * no font. Only when the registry is full is an unused font freed to
+ * make room, with its texts in the text cache.
+ */
+
+#ifndef _FONT_REGISTRY_H
+#define _FONT_REGISTRY_H
+
+#include<MLV/MLV_all.h>
+
+#define FONT_REGISTRY_SIZE 16      /**< Maximum number of fonts loaded at once */
+#define FONT_PATH_MAX_SIZE 128     /**< Maximum length of the path of a font, '\0' included */
+
+/**
+ * @brief Returns the font of a path and a size, loaded if needed.
+ *
+ * Exits the program if the font cannot be loaded or if the registry is
+ * full of used fonts.
+ *
+ * @param[in] path Path of the TTF file.
+ * @param[in] size Size of the font.
+ * @return MLV_Font* Font owned by the registry, valid until it is released.
+ */
+MLV_Font* acquire_font(const char *path, int size);
+
+/**
+ * @brief Gives back a font returned by acquire_font().
+ *
+ * @param[in] font The font.
+ */
+void release_font(MLV_Font *font);
+
+/**
+ * @brief Frees all the fonts and their texts in the text cache.
+ *
+ * No font may be used any more.
+ */
+void free_font_registry();
+
+/**
+ * @brief Prints the hits, loads and evictions of the registry.
+ */
+void print_font_registry_report();
+
+#endif /* _FONT_REGISTRY_H */
@@ -0,0 +1,202 @@
+#include"frame_profiler.h"
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<string.h>
+#include<time.h>
+
+#define FRAME_PROFILER_LINE_HEIGHT 16     /* pixels between two lines of the overlay */
+#define FRAME_PROFILER_OVERLAY_WIDTH 270  /* width of the overlay in pixels */
+#define FRAME_PROFILER_TEXT_SIZE 64       /* length of a line of the overlay */
+
+typedef struct {
+    PROFILER_LOOP loop;
+    unsigned long stages[PROFILER_STAGES_NUMBER]; /* nanoseconds */
+} ProfilerFrame;
+
+typedef struct {
+    int enabled;
+    int overlay;                                   /* 1 if the overlay is shown */
+
+    struct timespec starts[PROFILER_STAGES_NUMBER]; /* start of the running stages */
+    ProfilerFrame current;
+
+    ProfilerFrame frames[FRAME_PROFILER_RING_SIZE];
+    unsigned long frames_count;                    /* frames stored since the start */
+
+    /* percentiles shown by the overlay */
+    PROFILER_LOOP overlay_loop;
+    int overlay_frames;
+    unsigned long p50[PROFILER_STAGES_NUMBER];
+    unsigned long p99[PROFILER_STAGES_NUMBER];
+} FrameProfiler;
+
+static FrameProfiler frame_profiler;
+
+static const char *profiler_stage_names[PROFILER_STAGES_NUMBER] = {
+    "input", "update", "background", "objects", "body",
+    "head", "repaint", "hud", "present", "sleep"
+};
+
+static const char *profiler_loop_names[PROFILER_LOOPS_NUMBER] = {
+    "game", "menu"
+};
+
+static int compare_durations(const void *a, const void *b) {
+    unsigned long x, y;
+
+    x = *(const unsigned long*) a;
+    y = *(const unsigned long*) b;
+
+    return (x > y) - (x < y);
+}
+
+/*
+ * Computes the percentiles of the last frames of the loop of the last frame.
+ */
+static void update_profiler_percentiles() {
+    unsigned long samples[FRAME_PROFILER_WINDOW];
+    const ProfilerFrame *frame;
+    unsigned long i;
+    int stage, count;
+
+    frame_profiler.overlay_loop = frame_profiler.frames[(frame_profiler.frames_count - 1) % FRAME_PROFILER_RING_SIZE].loop;
+
+    for (stage = 0; stage < PROFILER_STAGES_NUMBER; stage++) {
+        count = 0;
+
+        /* newest first, only the frames still in the ring buffer */
+        for (i = frame_profiler.frames_count;
+             i > 0 && frame_profiler.frames_count - i < FRAME_PROFILER_RING_SIZE && count < FRAME_PROFILER_WINDOW;
+             i--) {
+            frame = &frame_profiler.frames[(i - 1) % FRAME_PROFILER_RING_SIZE];
+            if (frame->loop == frame_profiler.overlay_loop)
+                samples[count++] = frame->stages[stage];
+        }
+
+        qsort(samples, count, sizeof(unsigned long), compare_durations);
+
+        frame_profiler.p50[stage] = samples[(count - 1) * 50 / 100];
+        frame_profiler.p99[stage] = samples[(count - 1) * 99 / 100];
+        frame_profiler.overlay_frames = count;
+    }
+}
+
+void enable_frame_profiler(int enabled) {
+    frame_profiler.enabled = enabled;
+    discard_profiler_frame();
+}
+
+int is_frame_profiler_enabled() {
+    return frame_profiler.enabled;
+}
+
+void toggle_frame_profiler_overlay() {
+    frame_profiler.overlay = !frame_profiler.overlay;
+
+    if (frame_profiler.overlay && !frame_profiler.enabled)
+        enable_frame_profiler(1);
+}
+
+void begin_profiler_stage(PROFILER_STAGE stage) {
+    if (frame_profiler.enabled)
+        clock_gettime(CLOCK_MONOTONIC, &frame_profiler.starts[stage]);
+}
+
+void end_profiler_stage(PROFILER_STAGE stage) {
+    struct timespec now;
+    long duration;
+
+    if (frame_profiler.enabled) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        duration = (long) (now.tv_sec - frame_profiler.starts[stage].tv_sec) * 1000000000L +
+                   (now.tv_nsec - frame_profiler.starts[stage].tv_nsec);
+        if (duration > 0)
+            frame_profiler.current.stages[stage] += (unsigned long) duration;
+    }
+}
+
+void end_profiler_frame(PROFILER_LOOP loop) {
+    if (frame_profiler.enabled) {
+        frame_profiler.current.loop = loop;
+        frame_profiler.frames[frame_profiler.frames_count % FRAME_PROFILER_RING_SIZE] = frame_profiler.current;
+        frame_profiler.frames_count++;
+
+        if (frame_profiler.overlay &&
+            (frame_profiler.frames_count % FRAME_PROFILER_OVERLAY_PERIOD == 0 ||
+             frame_profiler.overlay_frames == 0 || loop != frame_profiler.overlay_loop))
+            update_profiler_percentiles();
+
+        discard_profiler_frame();
+    }
+}
+
+void discard_profiler_frame() {
+    memset(frame_profiler.current.stages, 0, sizeof(frame_profiler.current.stages));
+}
+
+void draw_frame_profiler_overlay(OutputStrategy *output) {
+    char text[FRAME_PROFILER_TEXT_SIZE];
+    int stage, y;
+
+    if (frame_profiler.overlay && frame_profiler.overlay_frames > 0) {
+        output->draw_filled_rectangle(output, 0, 0, FRAME_PROFILER_OVERLAY_WIDTH,
+                                      (PROFILER_STAGES_NUMBER + 2) * FRAME_PROFILER_LINE_HEIGHT,
+                                      MLV_COLOR_BLACK);
+
+        y = FRAME_PROFILER_LINE_HEIGHT / 2;
+        sprintf(text, "%s loop, %d frames      p50       p99",
+                profiler_loop_names[frame_profiler.overlay_loop], frame_profiler.overlay_frames);
+        output->draw_text(output, 8, y, text, MLV_COLOR_WHITE);
+
+        for (stage = 0; stage < PROFILER_STAGES_NUMBER; stage++) {
+            y += FRAME_PROFILER_LINE_HEIGHT;
+            sprintf(text, "%-10s %8.1f us %8.1f us", profiler_stage_names[stage],
+                    frame_profiler.p50[stage] / 1e3, frame_profiler.p99[stage] / 1e3);
+            output->draw_text(output, 8, y, text, MLV_COLOR_WHITE);
+        }
+    }
+}
+
+int save_frame_profiler_csv(const char *path) {
+    FILE *file;
+    const ProfilerFrame *frame;
+    unsigned long i, first;
+    int stage, res;
+
+    res = 1;
+
+    if (frame_profiler.frames_count > 0) {
+        file = fopen(path, "w");
+
+        if (file == NULL) {
+            fprintf(stderr, "Warining : can't write the frame profile %s\n", path);
+            res = 0;
+        } else {
+            fprintf(file, "frame,loop");
+            for (stage = 0; stage < PROFILER_STAGES_NUMBER; stage++)
+                fprintf(file, ",%s_ns", profiler_stage_names[stage]);
+            fprintf(file, "\n");
+
+            first = frame_profiler.frames_count > FRAME_PROFILER_RING_SIZE ?
+                    frame_profiler.frames_count - FRAME_PROFILER_RING_SIZE : 0;
+
+            for (i = first; i < frame_profiler.frames_count; i++) {
+                frame = &frame_profiler.frames[i % FRAME_PROFILER_RING_SIZE];
+
+                fprintf(file, "%lu,%s", i, profiler_loop_names[frame->loop]);
+                for (stage = 0; stage < PROFILER_STAGES_NUMBER; stage++)
+                    fprintf(file, ",%lu", frame->stages[stage]);
+                fprintf(file, "\n");
+            }
+
+            res = fclose(file) == 0;
+
+            printf("frame profiler: %lu frames written to %s\n",
+                   frame_profiler.frames_count - first, path);
+        }
+    }
+
+    return res;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file frame_profiler.h
+ * @brief Time spent in each stage of the frames of the game and menu loops.
+ *
+ * A loop brackets each stage of its frame (input, simulation, each part
+ * of the drawing, present, sleep) with begin_profiler_stage() and
+ * end_profiler_stage(); a stage run several times in a frame (the body
+ * of each snake) adds up. end_profiler_frame() stores the durations of
+ * the frame in a ring buffer of the last FRAME_PROFILER_RING_SIZE frames.
+ *
+ * ## Overhead
+ * The profiler is off until enable_frame_profiler(): every function then
+ * returns at once, without reading the clock.
+ *
+ * ## Overlay
+ * When shown, the overlay prints the median (p50) and the 99th percentile
+ * (p99) of each stage over the last FRAME_PROFILER_WINDOW frames of the
+ * loop, on an opaque box painted again every frame over the window. The
+ * percentiles are computed again every FRAME_PROFILER_OVERLAY_PERIOD
+ * frames. Showing the overlay turns the profiler on.
+ *
+ * ## CSV
+ * save_frame_profiler_csv() writes the frames of the ring buffer, oldest
+ * first, one line per frame with the duration of every stage in
+ * nanoseconds.
+ */
+
+#ifndef _FRAME_PROFILER_H
+#define _FRAME_PROFILER_H
+
+#include"output_strategy.h"
+
+#define FRAME_PROFILER_RING_SIZE 4096        /**< Frames kept in the ring buffer */
+#define FRAME_PROFILER_WINDOW 240            /**< Frames of the rolling percentiles of the overlay */
+#define FRAME_PROFILER_OVERLAY_PERIOD 30     /**< Frames between two updates of the overlay */
+#define FRAME_PROFILER_CSV_PATH "profile.csv" /**< File written at exit when frames were profiled */
+
+/**
+ * @enum PROFILER_STAGE
+ * @brief Timed stages of a frame.
+ */
+typedef enum {
+    PROFILER_STAGE_INPUT = 0,  /**< Events and buttons */
+    PROFILER_STAGE_UPDATE,     /**< Simulation ticks */
+    PROFILER_STAGE_BACKGROUND, /**< Animated background of the menus */
+    PROFILER_STAGE_OBJECTS,    /**< Apples and portals */
+    PROFILER_STAGE_BODY,       /**< Bodies of the snakes */
+    PROFILER_STAGE_HEAD,       /**< Heads of the snakes */
+    PROFILER_STAGE_REPAINT,    /**< Damage of the frame and repaint of the board */
+    PROFILER_STAGE_HUD,        /**< Scores, title and buttons */
+    PROFILER_STAGE_PRESENT,    /**< Present of the frame */
+    PROFILER_STAGE_SLEEP,      /**< Wait for the next frame */
+    PROFILER_STAGES_NUMBER
+} PROFILER_STAGE;
+
+/**
+ * @enum PROFILER_LOOP
+ * @brief Loop a frame belongs to.
+ */
+typedef enum {
+    PROFILER_LOOP_GAME = 0, /**< game_cycle() */
+    PROFILER_LOOP_MENU,     /**< show_menu_screen() */
+    PROFILER_LOOPS_NUMBER
+} PROFILER_LOOP;
+
+/**
+ * @brief Turns the profiler on or off.
+ *
+ * @param[in] enabled 1 to record the frames, 0 to stop.
+ */
+void enable_frame_profiler(int enabled);
+
+/**
+ * @brief Returns 1 if the profiler records the frames.
+ *
+ * @return int 1 if on, 0 otherwise.
+ */
+int is_frame_profiler_enabled();
+
+/**
+ * @brief Shows or hides the overlay, the profiler is turned on to show it.
+ */
+void toggle_frame_profiler_overlay();
+
+/**
+ * @brief Starts timing a stage of the current frame.
+ *
+ * @param[in] stage The stage.
+ */
+void begin_profiler_stage(PROFILER_STAGE stage);
+
+/**
+ * @brief Stops timing a stage and adds its duration to the current frame.
+ *
+ * @param[in] stage The stage, started by begin_profiler_stage().
+ */
+void end_profiler_stage(PROFILER_STAGE stage);
+
+/**
+ * @brief Stores the current frame in the ring buffer and starts a new one.
+ *
+ * @param[in] loop Loop of the frame.
+ */
+void end_profiler_frame(PROFILER_LOOP loop);
+
+/**
+ * @brief Drops the stages timed in the current frame.
+ *
+ * For a frame interrupted by a menu or a whole game, which would count
+ * the interruption in one of its stages.
+ */
+void discard_profiler_frame();
+
+/**
+ * @brief Draws the overlay in the top left corner, if it is shown.
+ *
+ * Meant to be called last before the frame is presented.
+ *
+ * @param[in,out] output Strategy painting the window.
+ */
+void draw_frame_profiler_overlay(OutputStrategy *output);
+
+/**
+ * @brief Writes the frames of the ring buffer in a CSV file.
+ *
+ * Nothing is written if no frame was profiled.
+ *
+ * @param[in] path Path of the file.
+ * @return int 1 if the file was written or nothing had to be, 0 on error.
+ */
+int save_frame_profiler_csv(const char *path);
+
+#endif /* _FRAME_PROFILER_H */
@@ -0,0 +1,177 @@
+#include"game_clock.h"
+
+#include<errno.h>
+
+/*
+ * Returns to - from in nanoseconds. The difference is meant for frame
+ * durations: it is limited to about two seconds to fit in a long.
+ */
+static long get_time_diff(const struct timespec *from, const struct timespec *to) {
+    long sec;
+
+    sec = (long) (to->tv_sec - from->tv_sec);
+    if (sec > 1)
+        sec = 1;
+    else if (sec < -1)
+        sec = -1;
+
+    return sec * (long) SEC_IN_NSEC + (to->tv_nsec - from->tv_nsec);
+}
+
+/*
+ * Adds a number of nanoseconds to a time.
+ */
+static void add_time(struct timespec *time, unsigned long nsec) {
+    time->tv_sec += nsec / SEC_IN_NSEC;
+    time->tv_nsec += nsec % SEC_IN_NSEC;
+
+    if (time->tv_nsec >= (long) SEC_IN_NSEC) {
+        time->tv_sec++;
+        time->tv_nsec -= SEC_IN_NSEC;
+    }
+}
+
+/*
+ * The next frame starts now.
+ */
+static void restart_game_clock_frame(GameClock *game_clock) {
+    clock_gettime(CLOCK_MONOTONIC, &game_clock->frame_start);
+
+    game_clock->deadline = game_clock->frame_start;
+    add_time(&game_clock->deadline, game_clock->frame_time);
+}
+
+void init_game_clock(GameClock *game_clock, unsigned long frame_time) {
+    game_clock->frame_time = frame_time;
+    game_clock->delta = 0;
+    game_clock->accumulator = 0;
+    game_clock->elapsed_ms = 0;
+    game_clock->elapsed_ns = 0;
+    game_clock->paused = 0;
+
+    game_clock->frames = 0;
+    game_clock->late_frames = 0;
+    game_clock->jitter_sum = 0;
+    game_clock->jitter_max = 0;
+
+    restart_game_clock_frame(game_clock);
+}
+
+unsigned long begin_game_clock_frame(GameClock *game_clock) {
+    struct timespec now;
+    long delta;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    delta = get_time_diff(&game_clock->frame_start, &now);
+    game_clock->frame_start = now;
+
+    if (game_clock->paused || delta < 0)
+        delta = 0;
+    else if ((unsigned long) delta > CLOCK_MAX_FRAME_TIME)
+        delta = CLOCK_MAX_FRAME_TIME;
+
+    game_clock->delta = (unsigned long) delta;
+    game_clock->accumulator += game_clock->delta;
+
+    game_clock->elapsed_ns += game_clock->delta;
+    game_clock->elapsed_ms += game_clock->elapsed_ns / MSEC_IN_NSEC;
+    game_clock->elapsed_ns %= MSEC_IN_NSEC;
+
+    return game_clock->delta;
+}
+
+int consume_game_clock_step(GameClock *game_clock, unsigned long step) {
+    int res;
+
+    res = game_clock->accumulator >= step;
+    if (res)
+        game_clock->accumulator -= step;
+
+    return res;
+}
+
+float get_game_clock_alpha(GameClock *game_clock, unsigned long step) {
+    float res;
+
+    res = (float) game_clock->accumulator / step;
+    if (res > 1.f)
+        res = 1.f;
+
+    return res;
+}
+
+unsigned long get_game_clock_time(GameClock *game_clock) {
+    struct timespec now;
+    long frame;
+    unsigned long res;
+
+    res = game_clock->elapsed_ms * 1000 + game_clock->elapsed_ns / 1000;
+
+    if (!game_clock->paused) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        frame = get_time_diff(&game_clock->frame_start, &now);
+        if (frame > 0)
+            res += (unsigned long) frame / 1000;
+    }
+
+    return res;
+}
+
+unsigned long get_game_clock_remaining(GameClock *game_clock) {
+    struct timespec now;
+    long left;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    left = get_time_diff(&now, &game_clock->deadline);
+
+    return left > 0 ? ((unsigned long) left + MSEC_IN_NSEC - 1) / MSEC_IN_NSEC : 0;
+}
+
+void wait_game_clock_frame(GameClock *game_clock) {
+    struct timespec now;
+    long late;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    if (get_time_diff(&now, &game_clock->deadline) > 0) {
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &game_clock->deadline, NULL) == EINTR)
+            ;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        late = get_time_diff(&game_clock->deadline, &now);
+        if (late < 0)
+            late = 0;
+
+        game_clock->frames++;
+        game_clock->jitter_sum += late;
+        if ((unsigned long) late > game_clock->jitter_max)
+            game_clock->jitter_max = (unsigned long) late;
+
+        add_time(&game_clock->deadline, game_clock->frame_time);
+    } else {
+        game_clock->late_frames++;
+
+        game_clock->deadline = now;
+        add_time(&game_clock->deadline, game_clock->frame_time);
+    }
+}
+
+void pause_game_clock(GameClock *game_clock) {
+    game_clock->paused = 1;
+}
+
+void resume_game_clock(GameClock *game_clock) {
+    game_clock->paused = 0;
+    restart_game_clock_frame(game_clock);
+}
+
+void print_game_clock_report(GameClock *game_clock, const char *name) {
+    double mean;
+
+    mean = game_clock->frames > 0 ? game_clock->jitter_sum / game_clock->frames : 0;
+
+    printf("%s: %lu frames, wake-up jitter mean %.1f us, max %.1f us, %lu late frames\n",
+           name, game_clock->frames,
+           mean / 1000., game_clock->jitter_max / 1000.,
+           game_clock->late_frames);
+}
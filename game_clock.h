@@ -0,0 +1,152 @@
+/**
+ * @file game_clock.h
+ * @brief Frame scheduler of the game and menu loops.
+ *
+ * The clock reads CLOCK_MONOTONIC, so it is not affected by changes of
+ * the wall clock, and sleeps until an absolute deadline with
+ * clock_nanosleep, so the frames do not drift.
+ *
+ * ## Fixed timestep
+ * Every frame, the measured frame duration is added to an accumulator.
+ * The loop then runs one simulation step for each whole `step` of time
+ * in the accumulator (consume_game_clock_step()), and draws the frame
+ * with the remaining fraction of a step (get_game_clock_alpha()) to
+ * interpolate the movement.
+ *
+ * ## Pause
+ * Between pause_game_clock() and resume_game_clock() no time is
+ * accumulated: a menu opened in the middle of a game does not make the
+ * snakes jump forward when it is closed.
+ *
+ * ## Jitter
+ * After each sleep, the delay between the deadline and the real wake-up
+ * is recorded. print_game_clock_report() shows the statistics.
+ *
+ * ## Timestamps
+ * get_game_clock_time() gives the running time at the moment of the call,
+ * pauses excluded, to timestamp events (e.g. key presses) in the same time
+ * base as the simulation steps.
+ */
+#ifndef _GAME_CLOCK_H
+#define _GAME_CLOCK_H
+
+#include<stdio.h>
+#include<time.h>
+
+#define MSEC_IN_NSEC 1000000UL                  /**< Conversion: milliseconds to nanoseconds */
+#define SEC_IN_NSEC ( 1000LU * MSEC_IN_NSEC )   /**< Conversion: seconds to nanoseconds */
+#define CLOCK_MAX_FRAME_TIME ( 250LU * MSEC_IN_NSEC ) /**< Longest frame duration accounted, in nanoseconds */
+
+/**
+ * @struct GameClock
+ * @brief State of the frame scheduler of one loop.
+ */
+typedef struct {
+    struct timespec frame_start; /**< Monotonic time of the start of the current frame */
+    struct timespec deadline;    /**< Monotonic time at which the next frame starts */
+    unsigned long frame_time;    /**< Target frame duration in nanoseconds */
+    unsigned long delta;         /**< Duration of the last frame in nanoseconds, pauses excluded */
+    unsigned long accumulator;   /**< Time not consumed by simulation steps yet, in nanoseconds */
+    unsigned long elapsed_ms;    /**< Running time in milliseconds, pauses excluded */
+    unsigned long elapsed_ns;    /**< Nanoseconds of running time not counted in elapsed_ms yet */
+    int paused;                  /**< 1 between pause_game_clock() and resume_game_clock() */
+
+    unsigned long frames;        /**< Number of frames which slept until their deadline */
+    unsigned long late_frames;   /**< Number of frames which ended after their deadline */
+    double jitter_sum;           /**< Sum of the wake-up delays in nanoseconds */
+    unsigned long jitter_max;    /**< Largest wake-up delay in nanoseconds */
+} GameClock;
+
+/**
+ * @brief Starts a clock, the first frame starts now.
+ *
+ * @param[out] game_clock Pointer to the clock.
+ * @param[in] frame_time Target frame duration in nanoseconds.
+ */
+void init_game_clock(GameClock *game_clock, unsigned long frame_time);
+
+/**
+ * @brief Starts a new frame and accumulates the duration of the previous one.
+ *
+ * The duration is limited to CLOCK_MAX_FRAME_TIME, so a long stall does
+ * not trigger a burst of simulation steps.
+ *
+ * @param[in,out] game_clock Pointer to the clock.
+ * @return unsigned long Duration of the previous frame in nanoseconds (0 if paused).
+ */
+unsigned long begin_game_clock_frame(GameClock *game_clock);
+
+/**
+ * @brief Takes one simulation step from the accumulated time.
+ *
+ * Meant to be called in a loop: `while (consume_game_clock_step(...)) update(...);`
+ *
+ * @param[in,out] game_clock Pointer to the clock.
+ * @param[in] step Duration of one simulation step in nanoseconds (greater than 0).
+ * @return int 1 if a step must be run, 0 if less than a step is accumulated.
+ */
+int consume_game_clock_step(GameClock *game_clock, unsigned long step);
+
+/**
+ * @brief Returns how far the time is between two simulation steps.
+ *
+ * @param[in] game_clock Pointer to the clock.
+ * @param[in] step Duration of one simulation step in nanoseconds (greater than 0).
+ * @return float Accumulated time divided by step, between 0 and 1.
+ */
+float get_game_clock_alpha(GameClock *game_clock, unsigned long step);
+
+/**
+ * @brief Returns the running time of the clock at the moment of the call.
+ *
+ * The time spent paused is not counted, the time since the start of the
+ * current frame is (unless the clock is paused).
+ *
+ * @param[in] game_clock Pointer to the clock.
+ * @return unsigned long Running time in microseconds.
+ */
+unsigned long get_game_clock_time(GameClock *game_clock);
+
+/**
+ * @brief Returns the time left before the end of the current frame.
+ *
+ * Meant to block on the input until the next frame instead of sleeping.
+ *
+ * @param[in] game_clock Pointer to the clock.
+ * @return unsigned long Time left in milliseconds, rounded up (0 if the frame is over).
+ */
+unsigned long get_game_clock_remaining(GameClock *game_clock);
+
+/**
+ * @brief Sleeps until the end of the current frame.
+ *
+ * If the frame is already over, nothing is waited and the next deadline
+ * is set one frame from now (the clock does not try to catch up).
+ *
+ * @param[in,out] game_clock Pointer to the clock.
+ */
+void wait_game_clock_frame(GameClock *game_clock);
+
+/**
+ * @brief Stops accumulating time, e.g. while a menu is opened.
+ *
+ * @param[in,out] game_clock Pointer to the clock.
+ */
+void pause_game_clock(GameClock *game_clock);
+
+/**
+ * @brief Accumulates time again, the time spent paused is skipped.
+ *
+ * @param[in,out] game_clock Pointer to the clock.
+ */
+void resume_game_clock(GameClock *game_clock);
+
+/**
+ * @brief Prints the frame and jitter statistics of a clock.
+ *
+ * @param[in] game_clock Pointer to the clock.
+ * @param[in] name Name of the loop, printed first.
+ */
+void print_game_clock_report(GameClock *game_clock, const char *name);
+
+#endif /* _GAME_CLOCK_H */
@@ -1,13 +1,15 @@
 #include"game_logic.h"
 
-void game_input(GameConfig* config) {
+int game_input(GameConfig* config, GameView *view, GameClock *game_clock) {
     MLV_Event event;
     MLV_Keyboard_modifier mod;
     MLV_Keyboard_button sym;
     MLV_Button_state state;
 
-    SnakeDirection first_player_dir, second_player_dir;
+    SnakeDirection direction;
+    int player, res;
 
+    res = 0;
 
     do {
 
@@ -22,64 +24,67 @@ void game_input(GameConfig* config) {
 
             if (state == MLV_PRESSED) {
 
-                first_player_dir = get_snake_next_rotation(&config->first_player);
-                second_player_dir = get_snake_next_rotation(&config->second_player);
+                player = -1;
+                direction = SNAKE_DIRECTION_RIGTH;
 
                 switch (sym) {
                 case MLV_KEYBOARD_w: case MLV_KEYBOARD_z:
-                    first_player_dir = SNAKE_DIRECTION_TOP;
+                    player = 0;
+                    direction = SNAKE_DIRECTION_TOP;
                     break;
                 case MLV_KEYBOARD_s:
-                    first_player_dir = SNAKE_DIRECTION_BOTTOM;
+                    player = 0;
+                    direction = SNAKE_DIRECTION_BOTTOM;
                     break;
                 case MLV_KEYBOARD_q: case MLV_KEYBOARD_a:
-                    first_player_dir = SNAKE_DIRECTION_LEFT;
+                    player = 0;
+                    direction = SNAKE_DIRECTION_LEFT;
                     break;
                 case MLV_KEYBOARD_d:
-                    first_player_dir = SNAKE_DIRECTION_RIGTH;
+                    player = 0;
+                    direction = SNAKE_DIRECTION_RIGTH;
                     break;
                 case MLV_KEYBOARD_UP:
-                    second_player_dir = SNAKE_DIRECTION_TOP;
+                    player = 1;
+                    direction = SNAKE_DIRECTION_TOP;
                     break;
                 case MLV_KEYBOARD_DOWN:
-                    second_player_dir = SNAKE_DIRECTION_BOTTOM;
+                    player = 1;
+                    direction = SNAKE_DIRECTION_BOTTOM;
                     break;
                 case MLV_KEYBOARD_LEFT:
-                    second_player_dir = SNAKE_DIRECTION_LEFT;
+                    player = 1;
+                    direction = SNAKE_DIRECTION_LEFT;
                     break;
                 case MLV_KEYBOARD_RIGHT:
-                    second_player_dir = SNAKE_DIRECTION_RIGTH;
+                    player = 1;
+                    direction = SNAKE_DIRECTION_RIGTH;
                     break;
                 case MLV_KEYBOARD_ESCAPE:
-                    show_menu(config);
+                    pause_game_clock(game_clock);
+                    show_menu(config, view);
+                    resume_game_clock(game_clock);
+                    discard_profiler_frame();
+                    res = 1;
+                    break;
+                case MLV_KEYBOARD_F3:
+                    toggle_frame_profiler_overlay();
+                    res = 1;
                     break;
                 default:
                     break;
                 }
 
-                set_snake_direction(&config->first_player, first_player_dir);
-                set_snake_direction(&config->second_player, second_player_dir);
+                /* MLV events carry no time: they are stamped when drained */
+                if (0 <= player && player < config->players_count)
+                    queue_snake_turn(&config->snakes[player], direction,
+                                     get_game_clock_time(game_clock));
             }
             
         }
     } while (event != MLV_NONE);
-    
-}
-
-void check_outofbounds(Snake *snake) {
-    vector2i *head_p;
-    
-    head_p = get_snake_head_position(snake);
-
-    if (head_p->x < 0)
-        head_p->x = GRID_SIZE - 1;
-    else if (GRID_SIZE <= head_p->x)
-        head_p->x = 0;
 
-    if (head_p->y < 0)
-        head_p->y = GRID_SIZE - 1;
-    else if (GRID_SIZE <= head_p->y)
-        head_p->y = 0;
+    return res;
 }
 
 void load_score(unsigned int *score_list) {
@@ -113,207 +118,108 @@ void update_score_list(unsigned int new_score) {
     serialize_game_score("score.bin", score_list, GAME_SCORE_LIST_SIZE);
 }
 
-int check_apple_eat(GameConfig *config, Snake *snake) {
-    GameObject *object;
-    vector2i *head_p;
-    int res, i;
-
-    res = 0;
-
-    head_p = get_snake_head_position(snake);
-
-    for (i = 0; i < GAME_OBJECTS_NUMBER && res == 0; i++) {
-        object = &config->objects[i];
-
-        if (object->type == GAME_OBJECT_APPLE) {
-            res = head_p->x == object->pos.x && head_p->y == object->pos.y;
-        }
-    }
-    
-    if (res) {
-        place_game_object(config, object);
-        config->score += 10;
-
-        config->move_timer = config->move_timer * SPEED_UP;
-
-        if (rand() % 100 <= PORTAL_REPLACE_CHANCE) {
-            replace_portals(config);
-        }
-    }
-
-    return res;
-}
-
-GameObject* check_portal_colision(Snake *snake, GameConfig *config) {
-    GameObject *main_portal, *end_portal;
-    vector2i *head_p;
-    int res, i, random_p;
-
-    res = 0;
-
-    head_p = get_snake_head_position(snake);
-
-    for (i = 0; i < GAME_OBJECTS_NUMBER && res == 0; i++) {
-        main_portal = &config->objects[i];
-
-        if (main_portal->type == GAME_OBJECT_PORTAL) {
-            res = head_p->x == main_portal->pos.x &&
-                  head_p->y == main_portal->pos.y;
-        }
-    }
-    
-    end_portal = NULL;
-    if (res) {
-
-        random_p = rand() % GAME_OBJECTS_NUMBER;
-
-        while (random_p >= 0) {
-
-            for (i = 0; i < GAME_OBJECTS_NUMBER && end_portal == NULL; i++) {
-                if (config->objects + i != main_portal &&
-                    config->objects[i].type == GAME_OBJECT_PORTAL) {
-                        if (random_p > 0) {
-                            random_p--;
-                        } else {
-                            end_portal = &config->objects[i];
-
-                            if (find_snake_part_by_position(snake, end_portal->pos) != -1) {
-                                end_portal = NULL;
-                            }
-
-                            random_p = -1;
-                        }
-                }
-            }
-        }
-    }
-
-    return end_portal;
-}
-
-void check_self_snake_colision(Snake *snake) {
-    vector2i *head_p, *tmp_p; 
-    size_t i;
-
-    head_p = get_snake_head_position(snake);
-
-    for (i = 4; i < get_snake_size(snake) && snake->is_alive; i++) {
-        tmp_p = get_snake_part_position(snake, i);
-
-        if (head_p->x == tmp_p->x && head_p->y == tmp_p->y)
-            snake->is_alive = 0;
-    }
-}
-
-void check_snake_colision(Snake *first, Snake *second) {
-    vector2i *head_p, *tmp_p; 
-    size_t i;
-
-    head_p = get_snake_head_position(first);
-
-    for (i = 0; i < get_snake_size(second) && first->is_alive; i++) {
-        tmp_p = get_snake_part_position(second, i);
-
-        if (head_p->x == tmp_p->x && head_p->y == tmp_p->y)
-            first->is_alive = 0;
-    }
-    
+void init_input_latency(InputLatency *latency) {
+    latency->turns = 0;
+    latency->sum = 0;
+    latency->max = 0;
 }
 
-void update_snake(GameConfig *config, Snake *snake, Snake *others, int count) {
+void record_input_latency(InputLatency *latency, GameConfig *config, unsigned long now) {
     int i;
-    GameObject *portal_move;
-    
-    if (snake->is_alive) {
-        portal_move = check_portal_colision(snake, config);
-
-        if (check_apple_eat(config, snake))
-            move_and_expand_snake(snake);
-        else
-            move_snake(snake);
-
-        if (portal_move != NULL) {
-            *get_snake_head_position(snake) = portal_move->pos;
-            move_snake(snake);
-        }
-        
+    Snake *snake;
+    unsigned long delay;
 
-        check_outofbounds(snake);
-        check_self_snake_colision(snake);
+    for (i = 0; i < config->players_count; i++) {
+        snake = &config->snakes[i];
 
-        for (i = 0; i < count && snake->is_alive; i++) {
-            check_snake_colision(snake, others + i);
-        }
+        if (snake->turn_applied) {
+            delay = now > snake->turn_time ? now - snake->turn_time : 0;
 
-        if (!snake->is_alive) {
-            move_back_snake(snake);
-            remove_tail_snake(snake);
+            latency->turns++;
+            latency->sum += delay;
+            if (delay > latency->max)
+                latency->max = delay;
 
-            if (portal_move != NULL)
-                move_back_snake(snake);
+            snake->turn_applied = 0;
         }
     }
 }
 
-void update_game(GameConfig *config) {
-    
-    switch (config->game_mode) {
-    case GAME_SINGLE_PLAYER_MODE:
-        update_snake(config, &config->first_player, NULL, 0);
-        break;
-    case GAME_TWO_PLAYER_MODE:
-        update_snake(config, &config->first_player, &config->second_player, 1);
-        update_snake(config, &config->second_player, &config->first_player, 1);
-        break;
-    default:
-        break;
-    }
+void print_input_latency_report(InputLatency *latency) {
+    double mean;
 
-}
+    mean = latency->turns > 0 ? latency->sum / latency->turns : 0;
 
+    printf("input latency: %lu turns, mean %.1f ms, max %.1f ms\n",
+           latency->turns, mean / 1000., latency->max / 1000.);
+}
 
-void game_cycle(GameConfig *config) {
-    struct timespec start_time, end_time;
-    unsigned long delta_time, next_move;
+void game_cycle(GameConfig *config, GameView *view) {
+    GameScreen screen;
+    GameClock game_clock;
+    InputLatency latency;
     unsigned int score_list[GAME_SCORE_LIST_SIZE];
 
-    next_move = 0;
-
     load_score(score_list);
     config->time = 0;
+
+    init_game_clock(&game_clock, DRAW_TIME);
+    init_input_latency(&latency);
+    reset_perf_counters();
+
+    init_game_screen_layers(&screen);
     
     while (!config->force_exit) {
 
-        clock_gettime(CLOCK_REALTIME, &start_time);
+        begin_game_clock_frame(&game_clock);
         
-        game_input(config);
-
-        if (next_move >= config->move_timer) {
-            next_move = 0;
+        /* the menu or the overlay drew over the game */
+        begin_profiler_stage(PROFILER_STAGE_INPUT);
+        if (game_input(config, view, &game_clock))
+            reset_game_screen(&screen);
+        end_profiler_stage(PROFILER_STAGE_INPUT);
+
+        /* one tick per move_timer of accumulated time */
+        begin_profiler_stage(PROFILER_STAGE_UPDATE);
+        while (!config->force_exit && consume_game_clock_step(&game_clock, config->move_timer)) {
+            begin_perf_section(PERF_SECTION_UPDATE);
             update_game(config);
-
+            end_perf_section(PERF_SECTION_UPDATE);
+            record_input_latency(&latency, config, get_game_clock_time(&game_clock));
         }
+        end_profiler_stage(PROFILER_STAGE_UPDATE);
 
-        draw_game(config, score_list, (float) next_move / config->move_timer);
+        config->time = game_clock.elapsed_ms;
 
-        clock_gettime(CLOCK_REALTIME, &end_time);
-        
-        delta_time = (end_time.tv_sec - start_time.tv_sec) * SEC_IN_NSEC + (end_time.tv_nsec - start_time.tv_nsec);
+        begin_perf_section(PERF_SECTION_DRAW);
+        draw_game(config, view, &screen, score_list, get_game_clock_alpha(&game_clock, config->move_timer));
+        end_perf_section(PERF_SECTION_DRAW);
 
-        if (delta_time <= DRAW_TIME) {
-            MLV_wait_milliseconds((DRAW_TIME - delta_time) / MSEC_IN_NSEC);
-            
-            next_move += DRAW_TIME;
-            config->time += DRAW_TIME * 1000 / SEC_IN_NSEC;
-        } else {
-            next_move += delta_time;
-            config->time += delta_time * 1000 / SEC_IN_NSEC;
-        }
+        begin_profiler_stage(PROFILER_STAGE_SLEEP);
+        wait_game_clock_frame(&game_clock);
+        end_profiler_stage(PROFILER_STAGE_SLEEP);
 
-        if (!config->first_player.is_alive && 
+        end_profiler_frame(PROFILER_LOOP_GAME);
+
+        if (!config->snakes[0].is_alive && 
             config->game_mode == GAME_SINGLE_PLAYER_MODE) {
             update_score_list(config->score);
             config->force_exit = 1;
         }
+
+        /* no room left for a new apple: the game is won */
+        if (config->board_full && !config->force_exit) {
+            if (config->game_mode == GAME_SINGLE_PLAYER_MODE)
+                update_score_list(config->score);
+            config->force_exit = 1;
+        }
     }
+
+    if (is_frame_profiler_enabled() || are_perf_counters_enabled()) {
+        print_game_clock_report(&game_clock, "game loop");
+        print_input_latency_report(&latency);
+    }
+    print_perf_counters_report();
+
+    free_game_screen_layers(&screen);
 }
\ No newline at end of file
@@ -2,8 +2,9 @@
  * @file game_logic.h
  * @brief Core logic and gameplay functions for the Snake game.
  *
- * This file defines the main gameplay mechanics, including input handling,
- * snake movement, collision detection, apple consumption, and game updates.
+ * This file defines the interactive part of the game: input handling,
+ * high scores and the main game loop. The simulation tick itself
+ * (movement, collisions, apples) is provided by game_update.h.
  * It also defines constants for frame rate and timing.
  */
 #ifndef _GAME_LOGIC_H
@@ -12,133 +13,104 @@
 #include<stdlib.h>
 #include<time.h>
 #include"game_config.h"
+#include"game_update.h"
 #include"game_screen.h"
 #include"game_menu.h"
+#include"game_clock.h"
+#include"frame_profiler.h"
+#include"perf_counters.h"
 
 #define FRAMERATE 120L                          /**< Target frames per second */
 
-#define MSEC_IN_NSEC 1000000UL                  /**< Conversion: milliseconds to nanoseconds */
-#define SEC_IN_NSEC ( 1000LU * MSEC_IN_NSEC )   /**< Conversion: seconds to nanoseconds */
-#define DRAW_TIME ( 1000LU / FRAMERATE )        /**< Nanoseconds per frame */
-#define MOVE_TIME ( 230LU * MSEC_IN_NSEC )      /**< Snake movement interval in nanoseconds */
+#define DRAW_TIME ( SEC_IN_NSEC / FRAMERATE )   /**< Nanoseconds per frame */
 
-#define SPEED_UP 498 / 500                      /**< Speed multiplier when apple is eaten */
+/**
+ * @struct InputLatency
+ * @brief Delays between the key presses of the players and the moves applying them.
+ */
+typedef struct {
+    unsigned long turns;   /**< Number of measured turns */
+    double sum;            /**< Sum of the delays in microseconds */
+    unsigned long max;     /**< Largest delay in microseconds */
+} InputLatency;
 
 /**
  * @brief Processes player input and updates snake directions.
  *
  * @param[in,out] config Pointer to the game configuration.
+ * @param[in,out] view Render data of the game (reloaded if a game is loaded from the menu).
+ * @param[in,out] game_clock Clock of the game loop, paused while the menu is opened.
  *
  * @details
- * Detects keyboard events and sets the next direction for each snake.
- * Also handles the ESCAPE key to open the menu.
- */
-void game_input(GameConfig *config);
-
-/**
- * @brief Wraps the snake around the grid if it goes out of bounds.
- *
- * @param[in,out] snake Pointer to the snake.
- */
-void check_outofbounds(Snake* snake);
-
-/**
- * @brief Loads the saved high scores.
- *
- * Initializes scores to zero if loading fails.
+ * Detects keyboard events and queues the turns of each player snake
+ * (see queue_snake_turn()), stamped with the running time of game_clock.
+ * Also handles the ESCAPE key to open the menu and the F3 key to show or
+ * hide the frame profiler overlay (frame_profiler.h).
  *
- * @param[out] score_list Array to store loaded scores.
- */
-void load_score(unsigned int *score_list);
-
-/**
- * @brief Updates the high score list with a new score.
- *
- * @param[in] new_score The score to insert into the list.
- *
- * @details
- * The function loads the current score list from "score.bin", inserts the new score
- * in descending order, avoids duplicates, and then saves the updated list back to the file.
+ * @return int 1 if the menu was opened or the overlay toggled (the game
+ *         screen must be repainted), 0 otherwise.
  */
-void update_score_list(unsigned int new_score);
+int game_input(GameConfig *config, GameView *view, GameClock *game_clock);
 
 /**
- * @brief Checks if the snake has eaten the apple.
- *
- * @param[in,out] config Pointer to the game configuration.
- * @param[in,out] snake Pointer to the snake.
- * @return int Returns 1 if apple was eaten, 0 otherwise.
+ * @brief Resets the input latency statistics.
  *
- * @details
- * If the apple is eaten, it is relocated to a new random position
- * and the snake's movement timer is adjusted (speed up).
+ * @param[out] latency Pointer to the statistics.
  */
-int check_apple_eat(GameConfig *config, Snake* snake);
+void init_input_latency(InputLatency *latency);
 
 /**
- * @brief Checks if the snake has collided with a portal.
- *
- * @param[in] snake Pointer to the snake.
- * @param[in] config Pointer to the game configuration.
- * @return GameObject* Returns a pointer to the destination portal if a collision occurs, NULL otherwise.
+ * @brief Records the turns applied by the player snakes during the last tick.
  *
- * @details
- * The function detects if the snake's head is on a portal. If so, it selects
- * a random other portal as the destination, ensuring the snake does not
- * teleport into itself.
+ * @param[in,out] latency Pointer to the statistics.
+ * @param[in,out] config Pointer to the game configuration (the turn_applied flags are cleared).
+ * @param[in] now Running time of the game clock in microseconds (see get_game_clock_time()).
  */
-GameObject* check_portal_colision(Snake *snake, GameConfig *config);
+void record_input_latency(InputLatency *latency, GameConfig *config, unsigned long now);
 
 /**
- * @brief Checks if the snake collided with itself.
+ * @brief Prints the input latency statistics.
  *
- * @param[in,out] snake Pointer to the snake.
- *
- * @details
- * Sets snake->is_alive to 0 if the head intersects with any part of its body.
+ * @param[in] latency Pointer to the statistics.
  */
-void check_self_snake_colision(Snake *snake);
+void print_input_latency_report(InputLatency *latency);
 
 /**
- * @brief Checks if one snake collides with another snake.
- *
- * @param[in,out] first Pointer to the first snake.
- * @param[in] second Pointer to the second snake.
+ * @brief Loads the saved high scores.
  *
- * @details
- * Sets first->is_alive to 0 if its head collides with any part of the second snake.
- */
-void check_snake_colision(Snake *first, Snake *second);
-
-/**
- * @brief Updates a single snake's state for one game tick.
+ * Initializes scores to zero if loading fails.
  *
- * @param[in,out] config Pointer to the game configuration.
- * @param[in,out] snake Pointer to the snake being updated.
- * @param[in] others Array of other snakes to check for collisions.
- * @param[in] count Number of other snakes in the array.
+ * @param[out] score_list Array to store loaded scores.
  */
-void update_snake(GameConfig *config, Snake *snake, Snake *others, int count);
+void load_score(unsigned int *score_list);
 
 /**
- * @brief Updates the state of the entire game for one tick.
+ * @brief Updates the high score list with a new score.
  *
- * @param[in,out] config Pointer to the game configuration.
+ * @param[in] new_score The score to insert into the list.
  *
  * @details
- * Calls update_snake for all active snakes depending on the game mode.
+ * The function loads the current score list from "score.bin", inserts the new score
+ * in descending order, avoids duplicates, and then saves the updated list back to the file.
  */
-void update_game(GameConfig *config);
+void update_score_list(unsigned int new_score);
 
 /**
  * @brief Main game loop.
  *
  * @param[in,out] config Pointer to the game configuration.
+ * @param[in,out] view Render data of the game.
  *
  * @details
  * Handles input, updates the game state, draws frames, and controls timing.
- * Runs until config->force_exit is set.
+ * The game ticks every config->move_timer nanoseconds of play (the time
+ * spent in the pause menu does not count), frames are drawn FRAMERATE
+ * times per second. Runs until config->force_exit is set, then prints the
+ * frame jitter measured by the GameClock and the input latency.
+ * The stages of each frame are timed by the frame profiler. If the
+ * hardware counters are opened (perf_counters.h), their values per
+ * update_game() and per draw_game() call in this game are printed too.
  */
-void game_cycle(GameConfig *config);
+void game_cycle(GameConfig *config, GameView *view);
 
 #endif /* _GAME_LOGIC_H */
\ No newline at end of file
@@ -13,62 +13,43 @@
 
 #include <stdlib.h>
 #include <time.h>
+#include <unistd.h>
+#include <SDL/SDL.h>
 
 /* =========================================================
- * Background noise helpers
+ * Background noise
  * ========================================================= */
 
-float hash(float n) {
-    return (float)fmod(sin(n) * 43758.5453123, 1.0);
-}
-
-float noise(float x, float y, float t) {
-    float fx;
-    float fy;
-
-    float a;
-    float b;
-    float c;
-    float d;
-
-    float u;
-    float v;
-
-    float lerp1;
-    float lerp2;
-
-    fx = (float)floor(x);
-    fy = (float)floor(y);
-
-    a = hash(fx + fy * 57.0f + t * 13.0f);
-    b = hash(fx + 1.0f + fy * 57.0f + t * 13.0f);
-    c = hash(fx + (fy + 1.0f) * 57.0f + t * 13.0f);
-    d = hash(fx + 1.0f + (fy + 1.0f) * 57.0f + t * 13.0f);
-
-    u = x - fx;
-    v = y - fy;
-
-    lerp1 = a + u * (b - a);
-    lerp2 = c + u * (d - c);
-
-    return lerp1 + v * (lerp2 - lerp1);
-}
-
-MLV_Color noise_color(
-    float x, float y,
-    float r, float g, float b,
-    float time_s,
-    float min_color, float max_color
-) {
-    float n;
-
-    n = noise(x * 0.1f, y * 0.1f, time_s * 0.15f);
+static NoisePipeline background_pipeline; /* colors of the tiles, computed by worker threads */
+static MLV_Image *background_images[2] = { NULL, NULL }; /* tiles of each field of the pipeline */
 
-    r *= min_color + n * (max_color - min_color);
-    g *= min_color + n * (max_color - min_color);
-    b *= min_color + n * (max_color - min_color);
+/*
+ * Points a target of the background pipeline to the pixels of an image.
+ * Returns 0 if they can't be written directly (not 32 bits, or the
+ * surface must be locked).
+ */
+static int get_image_noise_target(MLV_Image *image, NoiseTarget *target) {
+    SDL_Surface *surface;
+    int res;
+
+    surface = image != NULL ? MLV_get_image_data(image) : NULL;
+    res = surface != NULL && surface->format->BytesPerPixel == 4 && !SDL_MUSTLOCK(surface);
+
+    if (res) {
+        target->pixels = (uint32_t*) surface->pixels;
+        target->pitch = surface->pitch / 4;
+
+        target->shifts[0] = surface->format->Rshift;
+        target->shifts[1] = surface->format->Gshift;
+        target->shifts[2] = surface->format->Bshift;
+        target->shifts[3] = surface->format->Ashift;
+        target->masks[0] = surface->format->Rmask;
+        target->masks[1] = surface->format->Gmask;
+        target->masks[2] = surface->format->Bmask;
+        target->masks[3] = surface->format->Amask;
+    }
 
-    return MLV_rgba(r, g, b, 255);
+    return res;
 }
 
 /* =========================================================
@@ -91,8 +72,8 @@ void init_snake_in_square_bounds(Snake* s, int x_min, int y_min, int x_max, int
     if (length > max_len) {
         length = max_len;
     }
-    if (length > (int)MAX_SNAKE_SIZE) {
-        length = (int)MAX_SNAKE_SIZE;
+    if (length > (int)s->capacity) {
+        length = (int)s->capacity;
     }
 
     /* Head so that the body (extending left) stays inside the square */
@@ -135,14 +116,26 @@ void update_snake_square_turn(Snake* s, int x_min, int y_min, int x_max, int y_m
  * Background palette switching
  * ========================================================= */
 
-int pick_new_palette(int current, int palette_count) {
+int get_hovered_button(MLV_Button **buttons, int count, vector2i *mouse_p) {
+    int i, res;
+
+    res = -1;
+    for (i = 0; i < count && res == -1; i++) {
+        if (MLV_mouse_is_on_button(buttons[i], mouse_p))
+            res = i;
+    }
+
+    return res;
+}
+
+int pick_new_palette(int current, int palette_count, GameRandom *random) {
     int r;
 
     if (palette_count <= 1) {
         return 0;
     }
 
-    r = rand() % palette_count;
+    r = game_random_range(random, palette_count);
     if (r == current) {
         r = (r + 1) % palette_count;
     }
@@ -154,7 +147,11 @@ int pick_new_palette(int current, int palette_count) {
  * Main menu screen
  * ========================================================= */
 void draw_background(float time_s, int palette_i) {
-    int tile, title_height, x, y;
+    int i, j, tile, threads, index;
+    NoiseFrame frame;
+    NoiseField *field;
+    NoiseTarget targets[2];
+    uint32_t *colors;
     const struct Palette palettes[] = {
         /* purple + blue */
         { 0.75f, 0.20f, 1.00f,   0.20f, 0.45f, 1.00f },
@@ -166,62 +163,122 @@ void draw_background(float time_s, int palette_i) {
         { 1.00f, 0.95f, 0.20f,   1.00f, 0.55f, 0.10f }
     };
 
-    tile = 10;
-
-    title_height = SCREEN_HEIGH / 6;
-
-    for (y = 0; y < SCREEN_HEIGH; y += tile) {
-            for (x = 0; x < SCREEN_WIDTH; x += tile) {
-                if (y < title_height) {
-                    MLV_draw_filled_rectangle(
-                        x, y, tile, tile,
-                        noise_color(
-                            (float)x, (float)y,
-                            palettes[palette_i].top_r,
-                            palettes[palette_i].top_g,
-                            palettes[palette_i].top_b,
-                            time_s, 180.f, 255.f
-                        )
-                    );
-                } else {
-                    MLV_draw_filled_rectangle(
-                        x, y, tile, tile,
-                        noise_color(
-                            (float)x, (float)y,
-                            palettes[palette_i].bot_r,
-                            palettes[palette_i].bot_g,
-                            palettes[palette_i].bot_b,
-                            time_s, 185.f, 255.f
-                        )
-                    );
-                }
+    tile = MENU_BACKGROUND_TILE;
+
+    frame.top.r = palettes[palette_i].top_r;
+    frame.top.g = palettes[palette_i].top_g;
+    frame.top.b = palettes[palette_i].top_b;
+    frame.top.min_shade = 180.f;
+    frame.top.max_shade = 255.f;
+
+    frame.bottom.r = palettes[palette_i].bot_r;
+    frame.bottom.g = palettes[palette_i].bot_g;
+    frame.bottom.b = palettes[palette_i].bot_b;
+    frame.bottom.min_shade = 185.f;
+    frame.bottom.max_shade = 255.f;
+
+    /* rows starting above the bottom of the title */
+    frame.split_row = (SCREEN_HEIGH / 6 + tile - 1) / tile;
+    frame.time_s = time_s;
+
+    if (background_images[0] == NULL) {
+        /* the main thread computes its share of the bands too */
+        threads = (int) sysconf(_SC_NPROCESSORS_ONLN) - 1;
+        if (threads < 0)
+            threads = 0;
+
+        if (!init_noise_pipeline(&background_pipeline, SCREEN_WIDTH, SCREEN_HEIGH, tile, threads)) {
+            fprintf(stderr, "Error : can't allocate the menu background\n");
+            exit(EXIT_FAILURE);
+        }
+        background_images[0] = MLV_create_image(SCREEN_WIDTH, SCREEN_HEIGH);
+        background_images[1] = MLV_create_image(SCREEN_WIDTH, SCREEN_HEIGH);
+
+        /* the workers paint the tiles of their bands in the images */
+        if (get_image_noise_target(background_images[0], &targets[0]) &&
+            get_image_noise_target(background_images[1], &targets[1])) {
+            set_noise_pipeline_target(&background_pipeline, 0, &targets[0]);
+            set_noise_pipeline_target(&background_pipeline, 1, &targets[1]);
+        }
+
+        start_noise_frame(&background_pipeline, &frame);
+    }
+
+    /* the frame started during the previous call is shown, and the next
+       one is computed by the workers while this one is presented */
+    field = finish_noise_frame(&background_pipeline);
+    start_noise_frame(&background_pipeline, &frame);
+    index = (int) (field - background_pipeline.fields);
+
+    /* without access to the pixels, the tiles are filled here */
+    if (background_pipeline.targets[index].pixels == NULL) {
+        colors = field->colors;
+        for (j = 0; j < field->rows; j++) {
+            for (i = 0; i < field->columns; i++) {
+                MLV_draw_filled_rectangle_on_image(i * tile, j * tile, tile, tile,
+                                                   (MLV_Color) *colors, background_images[index]);
+                colors++;
             }
         }
+    }
+
+    MLV_draw_image(background_images[index], 0, 0);
 }
 
-void load_snake_skin_view(int index, MLV_Image **output) {
-    char path[35];
+void free_background() {
+    if (background_images[0] != NULL) {
+        /* the workers are stopped before their images are freed */
+        free_noise_pipeline(&background_pipeline);
+        MLV_free_image(background_images[0]);
+        MLV_free_image(background_images[1]);
+        background_images[0] = NULL;
+        background_images[1] = NULL;
+    }
+}
 
-    strcpy(path, SNAKE_SPRITE_BASE_PATH);
-    path[SNAKE_SPRITE_NUMBER_INDEX] = '0' + index % 10;
-    path[SNAKE_SPRITE_NUMBER_INDEX - 1] = '0' + index / 10 % 10;
-    path[SNAKE_SPRITE_NUMBER_INDEX - 2] = '0' + index / 100 % 10;
+void draw_menu_title(const char *title, MLV_Font *font) {
+    MLV_Image *image;
+    int tw, th;
 
-    if (output != NULL)
-        MLV_free_image(*output);
+    image = get_text_image(title, font, MLV_COLOR_WHITE, TEXT_STYLE_OUTLINE);
+
+    if (image != NULL) {
+        /* the outline is part of the image */
+        MLV_get_image_size(image, &tw, &th);
+        MLV_draw_image(image, (SCREEN_WIDTH - tw) / 2, (SCREEN_HEIGH / 6 - th) / 2);
+    }
+}
 
-    *output = MLV_load_image(path);
+void draw_menu_text_box(int x, int y, int width, int height, const char *text, MLV_Font *font) {
+    MLV_Image *image;
 
-    if (*output != NULL)
-        MLV_resize_image_with_proportions(*output, 
-                                          MENU_SNAKE_SPRITE_PREVIEW_SIZE, 
-                                          MENU_SNAKE_SPRITE_PREVIEW_SIZE);
+    image = get_text_box_image(text, font, width, height, 0,
+                               MLV_rgba(0, 0, 0, 0), MLV_COLOR_WHITE, MLV_rgba(0, 0, 0, 0));
+
+    if (image != NULL)
+        MLV_draw_image(image, x, y);
 }
 
-void select_solo_skin_dialog(GameConfig *config) {
+int change_skin_preview(int index, int step, MLV_Image **preview) {
+    int res;
+
+    res = ((index + step) % (MAX_SNAKE_SPRITE_INDEX + 1) + MAX_SNAKE_SPRITE_INDEX + 1) % (MAX_SNAKE_SPRITE_INDEX + 1);
+
+    /* borrowed before the old one is given back: it may be the same skin */
+    *preview = acquire_skin_preview(res);
+    release_skin_preview(index);
+
+    prefetch_skins(res);
+
+    return res;
+}
+
+void select_solo_skin_dialog(GameView *view) {
     vector2i mouse_p;
 
-    MLV_Button_state mouse_state, old_mouse_state;
+    MLV_Event event;
+    MLV_Mouse_button mouse_button;
+    MLV_Button_state mouse_state;
     MLV_Button prev_btn, next_btn, close_btn;
 
     MLV_Font *title_font;
@@ -229,9 +286,7 @@ void select_solo_skin_dialog(GameConfig *config) {
     MLV_Image *snake_sprite;
     int cancel_dialog, selected_skin;
     
-    struct timespec start_time;
-    struct timespec end_time;
-    unsigned long delta_time;
+    GameClock game_clock;
     float time_s;
 
     prev_btn = MLV_create_button_with_font("<=", "ressources/fonts/PixelifySans-VariableFont_wght.ttf", 24,
@@ -249,44 +304,30 @@ void select_solo_skin_dialog(GameConfig *config) {
         create_vector2i(SCREEN_WIDTH / 3, MENU_BUTTON_HEIGHT * 1.5), 
         MLV_COLOR_WHITE, MLV_COLOR_BLACK, MLV_COLOR_GREEN);
 
-    title_font = MLV_load_font("ressources/fonts/PixelifySans-VariableFont_wght.ttf", 64);
+    title_font = acquire_font("ressources/fonts/PixelifySans-VariableFont_wght.ttf", 64);
     
     time_s = 0.f;
     selected_skin = 0;
     cancel_dialog = 0;
-    old_mouse_state = MLV_PRESSED;
 
-    snake_sprite = NULL;
-    load_snake_skin_view(0, &snake_sprite);
+    snake_sprite = acquire_skin_preview(selected_skin);
+    prefetch_skins(selected_skin);
+
+    /* the clicks of the main menu are not for the dialog */
+    MLV_flush_event_queue();
+
+    init_game_clock(&game_clock, DRAW_TIME);
 
     while (!cancel_dialog) {
 
-        clock_gettime(CLOCK_REALTIME, &start_time);
+        time_s += (float) begin_game_clock_frame(&game_clock) / SEC_IN_NSEC;
         
         MLV_get_mouse_position(&mouse_p.x, &mouse_p.y);
 
         draw_background(time_s, 0);
 
         /* Title */
-        {
-            const char *title;
-            int tw;
-            int th;
-            int tx;
-            int ty;
-
-            title = "SKIN SELECTION";
-
-            MLV_get_size_of_text_with_font(title, &tw, &th, title_font);
-            tx = (SCREEN_WIDTH - tw) / 2;
-            ty = (SCREEN_HEIGH / 6 - th) / 2;
-
-            MLV_draw_text_with_font(tx - 2, ty, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx + 2, ty, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx, ty - 2, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx, ty + 2, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx, ty, title, title_font, MLV_COLOR_WHITE);
-        }
+        draw_menu_title("SKIN SELECTION", title_font);
 
         if (snake_sprite != NULL)
             MLV_draw_partial_image(snake_sprite, 
@@ -300,59 +341,49 @@ void select_solo_skin_dialog(GameConfig *config) {
 
         MLV_actualise_window();
 
-        mouse_state = MLV_get_mouse_button_state(MLV_BUTTON_LEFT);
-        if (mouse_state == MLV_PRESSED && old_mouse_state == MLV_RELEASED) {
-            if (MLV_mouse_is_on_button(&close_btn, &mouse_p)) {
-                cancel_dialog = 1;
-            }
-            else if (MLV_mouse_is_on_button(&prev_btn, &mouse_p)) {
-                selected_skin--;
-                if (selected_skin < 0)
-                    selected_skin = MAX_SNAKE_SPRITE_INDEX;
+        /* the inputs are handled as they come until the next frame of the background */
+        do {
+            event = MLV_wait_event_or_milliseconds(NULL, NULL, NULL, NULL, NULL,
+                                                   NULL, NULL, &mouse_button, &mouse_state,
+                                                   (int) get_game_clock_remaining(&game_clock));
 
-                load_snake_skin_view(selected_skin, &snake_sprite);
-            }
-            else if (MLV_mouse_is_on_button(&next_btn, &mouse_p)) {
-                selected_skin++;
-                if (selected_skin > MAX_SNAKE_SPRITE_INDEX)
-                    selected_skin = 0;
+            if (event == MLV_MOUSE_BUTTON && mouse_button == MLV_BUTTON_LEFT && mouse_state == MLV_PRESSED) {
+                MLV_get_mouse_position(&mouse_p.x, &mouse_p.y);
 
-                load_snake_skin_view(selected_skin, &snake_sprite);
+                if (MLV_mouse_is_on_button(&close_btn, &mouse_p)) {
+                    cancel_dialog = 1;
+                }
+                else if (MLV_mouse_is_on_button(&prev_btn, &mouse_p)) {
+                    selected_skin = change_skin_preview(selected_skin, -1, &snake_sprite);
+                }
+                else if (MLV_mouse_is_on_button(&next_btn, &mouse_p)) {
+                    selected_skin = change_skin_preview(selected_skin, 1, &snake_sprite);
+                }
             }
-        }
-
-        old_mouse_state = mouse_state;
+        } while (event != MLV_NONE && !cancel_dialog);
         
-        clock_gettime(CLOCK_REALTIME, &end_time);
-        delta_time = (end_time.tv_sec - start_time.tv_sec) * SEC_IN_NSEC +
-                     (unsigned long)(end_time.tv_nsec - start_time.tv_nsec);
-        if (delta_time <= DRAW_TIME) {
-            MLV_wait_milliseconds((DRAW_TIME - delta_time) / MSEC_IN_NSEC);
-            time_s += (float)DRAW_TIME / (float)SEC_IN_NSEC;
-        } else {
-            time_s += (float)delta_time / (float)SEC_IN_NSEC;
-        }
+        wait_game_clock_frame(&game_clock);
+
         if (time_s > 773.f)
             time_s = 0;
     }
 
-    if (snake_sprite != NULL)
-        MLV_free_image(snake_sprite);
-
-    load_snake_sprite(&config->first_player, selected_skin);
+    load_snake_sprite(&view->players[0], selected_skin);
+    release_skin_preview(selected_skin);
 
     MLV_free_button(&close_btn);
     MLV_free_button(&prev_btn);
     MLV_free_button(&next_btn);
 
-    MLV_free_font(title_font);
+    release_font(title_font);
 }
 
-void select_duo_skin_dialog(GameConfig *config) {
+void select_duo_skin_dialog(GameView *view) {
     vector2i mouse_p;
 
     MLV_Event event;
     MLV_Keyboard_button key;
+    MLV_Mouse_button mouse_button;
     MLV_Button_state btn_state;
 
     MLV_Button close_btn;
@@ -362,9 +393,7 @@ void select_duo_skin_dialog(GameConfig *config) {
 
     int cancel_dialog, first_selected_skin, second_selected_skin;
     
-    struct timespec start_time;
-    struct timespec end_time;
-    unsigned long delta_time;
+    GameClock game_clock;
     float time_s;
 
     close_btn = MLV_create_button_with_font("Start game", "ressources/fonts/PixelifySans-VariableFont_wght.ttf", 36,
@@ -372,8 +401,8 @@ void select_duo_skin_dialog(GameConfig *config) {
         create_vector2i(SCREEN_WIDTH / 3, MENU_BUTTON_HEIGHT * 1.5), 
         MLV_COLOR_WHITE, MLV_COLOR_BLACK, MLV_COLOR_GREEN);
     
-    title_font = MLV_load_font("ressources/fonts/PixelifySans-VariableFont_wght.ttf", 64);
-    text_font = MLV_load_font("ressources/fonts/PixelifySans-VariableFont_wght.ttf", 21);
+    title_font = acquire_font("ressources/fonts/PixelifySans-VariableFont_wght.ttf", 64);
+    text_font = acquire_font("ressources/fonts/PixelifySans-VariableFont_wght.ttf", 21);
     
     time_s = 0;
     first_selected_skin = 0;
@@ -381,41 +410,25 @@ void select_duo_skin_dialog(GameConfig *config) {
 
     cancel_dialog = 0;
 
-    first_snake_sprite = NULL;
-    second_snake_sprite = NULL;
-    load_snake_skin_view(0, &first_snake_sprite);
-    load_snake_skin_view(0, &second_snake_sprite);
+    first_snake_sprite = acquire_skin_preview(first_selected_skin);
+    second_snake_sprite = acquire_skin_preview(second_selected_skin);
+    prefetch_skins(first_selected_skin);
+
+    /* the clicks of the main menu are not for the dialog */
+    MLV_flush_event_queue();
+
+    init_game_clock(&game_clock, DRAW_TIME);
 
     while (!cancel_dialog) {
         
-        clock_gettime(CLOCK_REALTIME, &start_time);
+        time_s += (float) begin_game_clock_frame(&game_clock) / SEC_IN_NSEC;
 
         MLV_get_mouse_position(&mouse_p.x, &mouse_p.y);
-        event = MLV_get_event(&key, NULL, NULL, NULL, NULL,
-                              NULL, NULL, NULL, &btn_state);
 
         draw_background(time_s, 0);
 
         /* Title */
-        {
-            const char *title;
-            int tw;
-            int th;
-            int tx;
-            int ty;
-
-            title = "SKIN SELECTION";
-
-            MLV_get_size_of_text_with_font(title, &tw, &th, title_font);
-            tx = (SCREEN_WIDTH - tw) / 2;
-            ty = (SCREEN_HEIGH / 6 - th) / 2;
-
-            MLV_draw_text_with_font(tx - 2, ty, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx + 2, ty, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx, ty - 2, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx, ty + 2, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx, ty, title, title_font, MLV_COLOR_WHITE);
-        }
+        draw_menu_title("SKIN SELECTION", title_font);
 
         if (first_snake_sprite != NULL)
             MLV_draw_partial_image(first_snake_sprite, 
@@ -423,12 +436,9 @@ void select_duo_skin_dialog(GameConfig *config) {
                                    MENU_SNAKE_SPRITE_PREVIEW_SIZE / 2, MENU_SNAKE_SPRITE_PREVIEW_SIZE / 4, 
                                    SCREEN_WIDTH / 2 - MENU_SNAKE_SPRITE_PREVIEW_SIZE * 2 / 3, SCREEN_HEIGH / 2 - 20 - MENU_SNAKE_SPRITE_PREVIEW_SIZE / 4);
 
-        MLV_draw_text_box_with_font(
-                                SCREEN_WIDTH / 2 - MENU_SNAKE_SPRITE_PREVIEW_SIZE * 2 / 3, SCREEN_HEIGH / 2 - 20,
-                                MENU_SNAKE_SPRITE_PREVIEW_SIZE / 2, MENU_SNAKE_SPRITE_PREVIEW_SIZE / 4,
-                                "Select skin with Q and D", text_font, 0,
-                                MLV_rgba(0, 0, 0, 0), MLV_COLOR_WHITE, MLV_rgba(0, 0, 0, 0),
-                                MLV_TEXT_CENTER, MLV_HORIZONTAL_CENTER, MLV_VERTICAL_CENTER );
+        draw_menu_text_box(SCREEN_WIDTH / 2 - MENU_SNAKE_SPRITE_PREVIEW_SIZE * 2 / 3, SCREEN_HEIGH / 2 - 20,
+                           MENU_SNAKE_SPRITE_PREVIEW_SIZE / 2, MENU_SNAKE_SPRITE_PREVIEW_SIZE / 4,
+                           "Select skin with Q and D", text_font);
         
         if (second_snake_sprite != NULL)
             MLV_draw_partial_image(second_snake_sprite, 
@@ -436,88 +446,67 @@ void select_duo_skin_dialog(GameConfig *config) {
                                    MENU_SNAKE_SPRITE_PREVIEW_SIZE / 2, MENU_SNAKE_SPRITE_PREVIEW_SIZE / 4, 
                                    SCREEN_WIDTH / 2 + MENU_SNAKE_SPRITE_PREVIEW_SIZE / 5, SCREEN_HEIGH / 2 - 20 - MENU_SNAKE_SPRITE_PREVIEW_SIZE / 4);
 
-        MLV_draw_text_box_with_font(
-                                SCREEN_WIDTH / 2 + MENU_SNAKE_SPRITE_PREVIEW_SIZE / 5, SCREEN_HEIGH / 2 - 20,
-                                MENU_SNAKE_SPRITE_PREVIEW_SIZE / 2, MENU_SNAKE_SPRITE_PREVIEW_SIZE / 4,
-                                "Select skin with \nARROWS LEFT and RIGTH", text_font, 0,
-                                MLV_rgba(0, 0, 0, 0), MLV_COLOR_WHITE, MLV_rgba(0, 0, 0, 0),
-                                MLV_TEXT_CENTER, MLV_HORIZONTAL_CENTER, MLV_VERTICAL_CENTER );
+        draw_menu_text_box(SCREEN_WIDTH / 2 + MENU_SNAKE_SPRITE_PREVIEW_SIZE / 5, SCREEN_HEIGH / 2 - 20,
+                           MENU_SNAKE_SPRITE_PREVIEW_SIZE / 2, MENU_SNAKE_SPRITE_PREVIEW_SIZE / 4,
+                           "Select skin with \nARROWS LEFT and RIGTH", text_font);
         
         MLV_draw_button(&close_btn, &mouse_p);
 
         MLV_actualise_window();
 
-        switch (event) {
-            case MLV_MOUSE_BUTTON:
-                if (btn_state == MLV_PRESSED && 
-                    MLV_mouse_is_on_button(&close_btn, &mouse_p)) {
-                        cancel_dialog = 1;
-                }
-                break;
-            case MLV_KEY:
-                if (btn_state == MLV_PRESSED)
-                    switch (key) {
-                        case MLV_KEYBOARD_q:
-                            first_selected_skin--;
-                            if (first_selected_skin < 0)
-                                first_selected_skin = MAX_SNAKE_SPRITE_INDEX;
-
-                            load_snake_skin_view(first_selected_skin, &first_snake_sprite);
-                            break;
-                        case MLV_KEYBOARD_d:
-                            first_selected_skin++;
-                            if (first_selected_skin > MAX_SNAKE_SPRITE_INDEX)
-                                first_selected_skin = 0;
-
-                            load_snake_skin_view(first_selected_skin, &first_snake_sprite);
-                            break; 
-                        case MLV_KEYBOARD_LEFT:
-                            second_selected_skin--;
-                            if (second_selected_skin < 0)
-                                second_selected_skin = MAX_SNAKE_SPRITE_INDEX;
-
-                            load_snake_skin_view(second_selected_skin, &second_snake_sprite);
-                            break;
-                        case MLV_KEYBOARD_RIGHT:
-                            second_selected_skin++;
-                            if (second_selected_skin > MAX_SNAKE_SPRITE_INDEX)
-                                second_selected_skin = 0;
-
-                            load_snake_skin_view(second_selected_skin, &second_snake_sprite);
-                            break; 
-                        default:
-                            break;
+        /* every input is handled as it comes until the next frame of the background */
+        do {
+            event = MLV_wait_event_or_milliseconds(&key, NULL, NULL, NULL, NULL,
+                                                   NULL, NULL, &mouse_button, &btn_state,
+                                                   (int) get_game_clock_remaining(&game_clock));
+
+            switch (event) {
+                case MLV_MOUSE_BUTTON:
+                    MLV_get_mouse_position(&mouse_p.x, &mouse_p.y);
+                    if (btn_state == MLV_PRESSED && mouse_button == MLV_BUTTON_LEFT &&
+                        MLV_mouse_is_on_button(&close_btn, &mouse_p)) {
+                            cancel_dialog = 1;
                     }
-                break;
-            default:
-                break;
-        }
+                    break;
+                case MLV_KEY:
+                    if (btn_state == MLV_PRESSED)
+                        switch (key) {
+                            case MLV_KEYBOARD_q:
+                                first_selected_skin = change_skin_preview(first_selected_skin, -1, &first_snake_sprite);
+                                break;
+                            case MLV_KEYBOARD_d:
+                                first_selected_skin = change_skin_preview(first_selected_skin, 1, &first_snake_sprite);
+                                break; 
+                            case MLV_KEYBOARD_LEFT:
+                                second_selected_skin = change_skin_preview(second_selected_skin, -1, &second_snake_sprite);
+                                break;
+                            case MLV_KEYBOARD_RIGHT:
+                                second_selected_skin = change_skin_preview(second_selected_skin, 1, &second_snake_sprite);
+                                break; 
+                            default:
+                                break;
+                        }
+                    break;
+                default:
+                    break;
+            }
+        } while (event != MLV_NONE && !cancel_dialog);
         
-        clock_gettime(CLOCK_REALTIME, &end_time);
-        delta_time = (end_time.tv_sec - start_time.tv_sec) * SEC_IN_NSEC +
-                     (unsigned long)(end_time.tv_nsec - start_time.tv_nsec);
-        if (delta_time <= DRAW_TIME) {
-            MLV_wait_milliseconds((DRAW_TIME - delta_time) / MSEC_IN_NSEC);
-            time_s += (float)DRAW_TIME / (float)SEC_IN_NSEC;
-        } else {
-            time_s += (float)delta_time / (float)SEC_IN_NSEC;
-        }
+        wait_game_clock_frame(&game_clock);
+
         if (time_s > 773.f)
             time_s = 0;
     }
 
-    if (first_snake_sprite != NULL)
-        MLV_free_image(first_snake_sprite);
-    if (second_snake_sprite != NULL)
-        MLV_free_image(second_snake_sprite);
-
-    load_snake_sprite(&config->first_player, first_selected_skin);
-    load_snake_sprite(&config->second_player, second_selected_skin);
+    load_snake_sprite(&view->players[0], first_selected_skin);
+    load_snake_sprite(&view->players[1], second_selected_skin);
+    release_skin_preview(first_selected_skin);
+    release_skin_preview(second_selected_skin);
 
     MLV_free_button(&close_btn);
 
-    MLV_free_font(title_font);
-    MLV_free_font(text_font);
+    release_font(title_font);
+    release_font(text_font);
 }
 
 void show_menu_screen() {
@@ -539,17 +528,15 @@ void show_menu_screen() {
     int menu_dialog;
 
     /* ---- drawing / timing ---- */
-    int title_height;
-
     float time_s;
 
-    struct timespec start_time;
-    struct timespec end_time;
-    unsigned long delta_time;
-    unsigned long next_move;
+    GameClock game_clock;
+    struct timespec startup_begin, startup_end;
+    int startup_printed;
 
     /* ---- game config ---- */
     GameConfig config;
+    GameView view;
 
     /* ---- colors ---- */
     MLV_Color menu_button_color;
@@ -570,6 +557,10 @@ void show_menu_screen() {
 
     Snake snakes_right[5];
     Snake snakes_left[2];
+    vector2i items_right[5][MENU_SNAKE_CAPACITY];
+    vector2i items_left[2][MENU_SNAKE_CAPACITY];
+    SnakeView views_right[5];
+    SnakeView views_left[2];
 
     int rx_min[5];
     int ry_min[5];
@@ -602,10 +593,18 @@ void show_menu_screen() {
 
     const int palette_count = (int)(sizeof(palettes) / sizeof(palettes[0]));
     int palette_i;
+    GameRandom menu_random;
+
+    /* cold start: from here to the first frame of the menu, printed with --profile */
+    clock_gettime(CLOCK_MONOTONIC, &startup_begin);
+    startup_printed = !is_frame_profiler_enabled();
 
     init_game_screen();
 
-    title_font = MLV_load_font("ressources/fonts/PixelifySans-VariableFont_wght.ttf", 64);
+    /* the menu draws the seed of every new game */
+    seed_game_random(&menu_random, (unsigned long) time(NULL));
+
+    title_font = acquire_font("ressources/fonts/PixelifySans-VariableFont_wght.ttf", 64);
 
     palette_i = 0;
 
@@ -646,8 +645,9 @@ void show_menu_screen() {
         ry_min[i] = outer_y_min + inset;
         ry_max[i] = outer_y_max - inset;
 
-        snakes_right[i] = create_snake();
-        load_snake_sprite(&snakes_right[i], preset_right[i]);
+        snakes_right[i] = create_snake(items_right[i], MENU_SNAKE_CAPACITY);
+        views_right[i] = create_snake_view();
+        load_snake_sprite(&views_right[i], preset_right[i]);
         init_snake_in_square_bounds(&snakes_right[i], rx_min[i], ry_min[i], rx_max[i], snake_length_right);
     }
 
@@ -658,8 +658,9 @@ void show_menu_screen() {
     lx_min[1] = 2;  lx_max[1] = 5;  ly_min[1] = 8;  ly_max[1] = 13;
 
     for (i = 0; i < 2; i++) {
-        snakes_left[i] = create_snake();
-        load_snake_sprite(&snakes_left[i], preset_left[i]);
+        snakes_left[i] = create_snake(items_left[i], MENU_SNAKE_CAPACITY);
+        views_left[i] = create_snake_view();
+        load_snake_sprite(&views_left[i], preset_left[i]);
         init_snake_in_square_bounds(&snakes_left[i], lx_min[i], ly_min[i], lx_max[i], snake_length_left);
     }
 
@@ -726,53 +727,50 @@ void show_menu_screen() {
      * Loop state
      * ------------------------------------------------- */
     menu_dialog = 1;
+    config.arena = NULL; /* no game loaded yet */
     time_s = 760.0f;
-    next_move = 0;
     prev_mouse_state = MLV_RELEASED;
 
+    init_game_clock(&game_clock, DRAW_TIME);
+
     while (menu_dialog) {
 
         MLV_get_mouse_position(&mouse_p.x, &mouse_p.y);
 
-        clock_gettime(CLOCK_REALTIME, &start_time);
-
-        title_height = SCREEN_HEIGH / 6;
+        time_s += (float) begin_game_clock_frame(&game_clock) / SEC_IN_NSEC;
 
         /* Background */
+        begin_profiler_stage(PROFILER_STAGE_BACKGROUND);
         draw_background(time_s, palette_i);
+        end_profiler_stage(PROFILER_STAGE_BACKGROUND);
 
         /* Title */
-        {
-            const char *title;
-            int tw;
-            int th;
-            int tx;
-            int ty;
-
-            title = "SNAKE GAME";
-
-            MLV_get_size_of_text_with_font(title, &tw, &th, title_font);
-            tx = (SCREEN_WIDTH - tw) / 2;
-            ty = (title_height - th) / 2;
-
-            MLV_draw_text_with_font(tx - 2, ty, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx + 2, ty, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx, ty - 2, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx, ty + 2, title, title_font, MLV_COLOR_BLACK);
-            MLV_draw_text_with_font(tx, ty, title, title_font, MLV_COLOR_WHITE);
-        }
+        begin_profiler_stage(PROFILER_STAGE_HUD);
+        draw_menu_title("SNAKE GAME", title_font);
+        end_profiler_stage(PROFILER_STAGE_HUD);
 
         /* Draw snakes first so they appear under the buttons */
         for (i = 0; i < 5; i++) {
-            draw_snake_body(&snakes_right[i], (float)next_move / MOVE_TIME);
-            draw_snake_head(&snakes_right[i], (float)next_move / MOVE_TIME);
+            begin_profiler_stage(PROFILER_STAGE_BODY);
+            draw_snake_body(&snakes_right[i], &views_right[i], get_game_clock_alpha(&game_clock, MOVE_TIME), NULL);
+            end_profiler_stage(PROFILER_STAGE_BODY);
+
+            begin_profiler_stage(PROFILER_STAGE_HEAD);
+            draw_snake_head(&snakes_right[i], &views_right[i], get_game_clock_alpha(&game_clock, MOVE_TIME), NULL);
+            end_profiler_stage(PROFILER_STAGE_HEAD);
         }
         for (i = 0; i < 2; i++) {
-            draw_snake_body(&snakes_left[i], (float)next_move / MOVE_TIME);
-            draw_snake_head(&snakes_left[i], (float)next_move / MOVE_TIME);
+            begin_profiler_stage(PROFILER_STAGE_BODY);
+            draw_snake_body(&snakes_left[i], &views_left[i], get_game_clock_alpha(&game_clock, MOVE_TIME), NULL);
+            end_profiler_stage(PROFILER_STAGE_BODY);
+
+            begin_profiler_stage(PROFILER_STAGE_HEAD);
+            draw_snake_head(&snakes_left[i], &views_left[i], get_game_clock_alpha(&game_clock, MOVE_TIME), NULL);
+            end_profiler_stage(PROFILER_STAGE_HEAD);
         }
 
         /* Buttons */
+        begin_profiler_stage(PROFILER_STAGE_HUD);
         MLV_get_mouse_position(&mouse_p.x, &mouse_p.y);
 
         MLV_draw_button(&bg_btn, &mouse_p);
@@ -781,41 +779,77 @@ void show_menu_screen() {
         MLV_draw_button(&start_two_player_btn, &mouse_p);
         MLV_draw_button(&load_btn, &mouse_p);
         MLV_draw_button(&exit_btn, &mouse_p);
+        end_profiler_stage(PROFILER_STAGE_HUD);
+
+        draw_frame_profiler_overlay(get_output_strategy());
 
+        begin_profiler_stage(PROFILER_STAGE_PRESENT);
         MLV_actualise_window();
+        end_profiler_stage(PROFILER_STAGE_PRESENT);
+
+        if (!startup_printed) {
+            clock_gettime(CLOCK_MONOTONIC, &startup_end);
+            printf("startup: %.1f ms, images from %s\n",
+                   (startup_end.tv_sec - startup_begin.tv_sec) * 1e3 +
+                   (startup_end.tv_nsec - startup_begin.tv_nsec) / 1e6,
+                   get_game_assets() != NULL ? ASSET_BUNDLE_PATH : "the PNG files");
+            startup_printed = 1;
+        }
 
+        begin_profiler_stage(PROFILER_STAGE_INPUT);
         mouse_state = MLV_get_mouse_button_state(MLV_BUTTON_LEFT);
 
         /* Debounced click: trigger only on RELEASED -> PRESSED */
         if (mouse_state == MLV_PRESSED && prev_mouse_state == MLV_RELEASED) {
 
             if (MLV_mouse_is_on_button(&bg_btn, &mouse_p)) {
-                palette_i = pick_new_palette(palette_i, palette_count);
+                palette_i = pick_new_palette(palette_i, palette_count, &menu_random);
             }
 
             if (MLV_mouse_is_on_button(&start_signle_btn, &mouse_p)) {
-                init_game(&config, GAME_SINGLE_PLAYER_MODE);
-                config.move_timer = MOVE_TIME;
-
-                select_solo_skin_dialog(&config);
-                game_cycle(&config);
-                free_game_config(&config);
+                if (init_game(&config, GAME_SINGLE_PLAYER_MODE, GRID_SIZE, GRID_SIZE,
+                              next_game_random(&menu_random))) {
+                    pause_game_clock(&game_clock);
+                    init_game_view(&view);
+                    config.move_timer = MOVE_TIME;
+
+                    select_solo_skin_dialog(&view);
+                    load_game_view(&view, &config);
+                    game_cycle(&config, &view);
+                    free_game_view(&view);
+                    free_game(&config);
+                    resume_game_clock(&game_clock);
+                    discard_profiler_frame();
+                }
             }
 
             if (MLV_mouse_is_on_button(&start_two_player_btn, &mouse_p)) {
-                init_game(&config, GAME_TWO_PLAYER_MODE);
-                config.move_timer = MOVE_TIME;
-
-                select_duo_skin_dialog(&config);
-                game_cycle(&config);
-                free_game_config(&config);
+                if (init_game(&config, GAME_TWO_PLAYER_MODE, GRID_SIZE, GRID_SIZE,
+                              next_game_random(&menu_random))) {
+                    pause_game_clock(&game_clock);
+                    init_game_view(&view);
+                    config.move_timer = MOVE_TIME;
+
+                    select_duo_skin_dialog(&view);
+                    load_game_view(&view, &config);
+                    game_cycle(&config, &view);
+                    free_game_view(&view);
+                    free_game(&config);
+                    resume_game_clock(&game_clock);
+                    discard_profiler_frame();
+                }
             }
 
             if (MLV_mouse_is_on_button(&load_btn, &mouse_p)) {
-                if (deserialize_game("save.bin", &config)) {
-                    game_cycle(&config);
-                    free_game_config(&config);
+                pause_game_clock(&game_clock);
+                init_game_view(&view);
+                if (deserialize_game("save.bin", &config, &view)) {
+                    game_cycle(&config, &view);
+                    free_game(&config);
                 }
+                free_game_view(&view);
+                resume_game_clock(&game_clock);
+                discard_profiler_frame();
             }
 
             if (MLV_mouse_is_on_button(&exit_btn, &mouse_p)) {
@@ -824,9 +858,11 @@ void show_menu_screen() {
         }
 
         prev_mouse_state = mouse_state;
+        end_profiler_stage(PROFILER_STAGE_INPUT);
 
         /* Movement tick */
-        if (next_move >= MOVE_TIME) {
+        begin_profiler_stage(PROFILER_STAGE_UPDATE);
+        while (consume_game_clock_step(&game_clock, MOVE_TIME)) {
             for (i = 0; i < 5; i++) {
                 update_snake_square_turn(&snakes_right[i], rx_min[i], ry_min[i], rx_max[i], ry_max[i]);
                 move_snake(&snakes_right[i]);
@@ -835,33 +871,34 @@ void show_menu_screen() {
                 update_snake_square_turn(&snakes_left[i], lx_min[i], ly_min[i], lx_max[i], ly_max[i]);
                 move_snake(&snakes_left[i]);
             }
-            next_move = 0;
         }
+        end_profiler_stage(PROFILER_STAGE_UPDATE);
 
         /* Frame pacing */
-        clock_gettime(CLOCK_REALTIME, &end_time);
-        delta_time = (end_time.tv_sec - start_time.tv_sec) * SEC_IN_NSEC +
-                     (unsigned long)(end_time.tv_nsec - start_time.tv_nsec);
-
-        if (delta_time <= DRAW_TIME) {
-            MLV_wait_milliseconds((DRAW_TIME - delta_time) / MSEC_IN_NSEC);
-            next_move += DRAW_TIME;
-            time_s += (float)DRAW_TIME / (float)SEC_IN_NSEC;
-        } else {
-            next_move += delta_time;
-            time_s += (float)delta_time / (float)SEC_IN_NSEC;
-        }
+        begin_profiler_stage(PROFILER_STAGE_SLEEP);
+        wait_game_clock_frame(&game_clock);
+        end_profiler_stage(PROFILER_STAGE_SLEEP);
+
+        end_profiler_frame(PROFILER_LOOP_MENU);
 
         if (time_s > 773.f)
             time_s = 0;
     }
 
+    if (is_frame_profiler_enabled() || are_perf_counters_enabled())
+        print_game_clock_report(&game_clock, "main menu");
+    if (is_frame_profiler_enabled()) {
+        print_text_cache_report();
+        print_skin_cache_report();
+        print_font_registry_report();
+    }
+
     /* Cleanup snakes */
     for (i = 0; i < 5; i++) {
-        free_snake(&snakes_right[i]);
+        free_snake_view(&views_right[i]);
     }
     for (i = 0; i < 2; i++) {
-        free_snake(&snakes_left[i]);
+        free_snake_view(&views_left[i]);
     }
 
     /* Cleanup buttons + window */
@@ -872,7 +909,13 @@ void show_menu_screen() {
     MLV_free_button(&exit_btn);
 
     /* Clean fonts */
-    MLV_free_font(title_font);
+    release_font(title_font);
+
+    free_background();
+    free_font_registry();
+    free_text_cache();
+    free_skin_cache();
+    free_game_assets();
 
     free_game_screen();
 }
@@ -881,7 +924,7 @@ void show_menu_screen() {
  * In-game pause menu
  * ========================================================= */
 
-void show_menu(GameConfig *config) {
+void show_menu(GameConfig *config, GameView *view) {
     vector2i mouse_p;
     vector2i tmp_p;
     vector2i btn_size;
@@ -891,8 +934,14 @@ void show_menu(GameConfig *config) {
     MLV_Button save_btn;
     MLV_Button load_btn;
 
+    MLV_Button *buttons[4];
+
+    MLV_Event event;
+    MLV_Mouse_button mouse_button;
     MLV_Button_state mouse_state;
-    int menu_dialog;
+    int menu_dialog, redraw, hovered, old_hovered;
+
+    GameClock game_clock;
 
     tmp_p = create_vector2i(MENU_POSS_X + MENU_PADDDING, MENU_POSS_Y + MENU_PADDDING);
     btn_size = create_vector2i(MENU_WIDTH - MENU_PADDDING * 2, MENU_PADDDING);
@@ -908,34 +957,61 @@ void show_menu(GameConfig *config) {
     tmp_p.y += MENU_PADDDING + MENU_BUTTON_HEIGHT;
     stop_btn = MLV_create_base_button("Stop Game", tmp_p, btn_size);
 
+    buttons[0] = &continue_btn;
+    buttons[1] = &save_btn;
+    buttons[2] = &load_btn;
+    buttons[3] = &stop_btn;
+
     menu_dialog = 1;
+    redraw = 1;
+
+    MLV_get_mouse_position(&mouse_p.x, &mouse_p.y);
+    hovered = get_hovered_button(buttons, 4, &mouse_p);
+
+    init_game_clock(&game_clock, DRAW_TIME);
 
     while (menu_dialog) {
 
-        MLV_get_mouse_position(&mouse_p.x, &mouse_p.y);
+        /* drawn only when it changes, at most once per frame */
+        if (redraw) {
+            begin_game_clock_frame(&game_clock);
 
-        MLV_draw_filled_rectangle(
-            MENU_POSS_X, MENU_POSS_Y,
-            MENU_WIDTH, MENU_HEIGHT,
-            MLV_COLOR_WHITE
-        );
+            MLV_draw_filled_rectangle(
+                MENU_POSS_X, MENU_POSS_Y,
+                MENU_WIDTH, MENU_HEIGHT,
+                MLV_COLOR_WHITE
+            );
 
-        MLV_draw_rectangle(
-            MENU_POSS_X, MENU_POSS_Y,
-            MENU_WIDTH, MENU_HEIGHT,
-            MLV_COLOR_BLACK
-        );
+            MLV_draw_rectangle(
+                MENU_POSS_X, MENU_POSS_Y,
+                MENU_WIDTH, MENU_HEIGHT,
+                MLV_COLOR_BLACK
+            );
 
-        MLV_draw_button(&continue_btn, &mouse_p);
-        MLV_draw_button(&save_btn, &mouse_p);
-        MLV_draw_button(&load_btn, &mouse_p);
-        MLV_draw_button(&stop_btn, &mouse_p);
+            MLV_draw_button(&continue_btn, &mouse_p);
+            MLV_draw_button(&save_btn, &mouse_p);
+            MLV_draw_button(&load_btn, &mouse_p);
+            MLV_draw_button(&stop_btn, &mouse_p);
 
-        MLV_actualise_window();
+            MLV_actualise_window();
 
-        mouse_state = MLV_get_mouse_button_state(MLV_BUTTON_LEFT);
+            redraw = 0;
+            wait_game_clock_frame(&game_clock);
+        }
+
+        /* sleeps until an input, the timeout catches a mouse which left the window */
+        event = MLV_wait_event_or_milliseconds(NULL, NULL, NULL, NULL, NULL,
+                                               NULL, NULL, &mouse_button, &mouse_state,
+                                               MENU_EVENT_TIMEOUT);
+
+        MLV_get_mouse_position(&mouse_p.x, &mouse_p.y);
+
+        old_hovered = hovered;
+        hovered = get_hovered_button(buttons, 4, &mouse_p);
+        if (hovered != old_hovered)
+            redraw = 1;
 
-        if (mouse_state == MLV_PRESSED) {
+        if (event == MLV_MOUSE_BUTTON && mouse_button == MLV_BUTTON_LEFT && mouse_state == MLV_PRESSED) {
 
             if (MLV_mouse_is_on_button(&continue_btn, &mouse_p)) {
                 menu_dialog = 0;
@@ -947,12 +1023,12 @@ void show_menu(GameConfig *config) {
             }
 
             if (MLV_mouse_is_on_button(&save_btn, &mouse_p)) {
-                serialize_game("save.bin", config);
+                serialize_game("save.bin", config, view);
                 menu_dialog = 0;
             }
 
             if (MLV_mouse_is_on_button(&load_btn, &mouse_p)) {
-                deserialize_game("save.bin", config);
+                deserialize_game("save.bin", config, view);
                 menu_dialog = 0;
             }
         }
@@ -16,9 +16,13 @@
 #include<stdint.h>
 
 #include"game_config.h"
+#include"game_view.h"
 #include"game_logic.h"
 #include"game_serializer.h"
 #include"mlv_button.h"
+#include"noise_pipeline.h"
+#include"text_cache.h"
+#include"skin_cache.h"
 
 #define MENU_POSS_X ( SCREEN_WIDTH / 3 )       /**< X position of the menu */
 #define MENU_POSS_Y ( SCREEN_HEIGH / 5 )       /**< Y position of the menu */
@@ -27,7 +31,10 @@
 #define MENU_PADDDING ( MENU_HEIGHT / 10 )     /**< Padding between buttons */
 #define MENU_BUTTON_HEIGHT 40                  /**< Height of menu buttons */
 
-#define MENU_SNAKE_SPRITE_PREVIEW_SIZE 512
+#define MENU_SNAKE_SPRITE_PREVIEW_SIZE SKIN_PREVIEW_SIZE
+#define MENU_SNAKE_CAPACITY 8                  /**< Buffer size of the decorative menu snakes */
+#define MENU_BACKGROUND_TILE 10                /**< Side of a tile of the background noise in pixels */
+#define MENU_EVENT_TIMEOUT 250                 /**< Longest wait for an input in the pause menu, in milliseconds */
 
 /**
  * @brief Color palette for menu background.
@@ -44,36 +51,88 @@ struct Palette {
 /**
  * @brief Draws the animated background for the main menu.
  *
+ * The noise of the tiles is computed by a NoisePipeline
+ * (noise_pipeline.h), whose threads also paint the tiles in one image
+ * per field, so a call only draws an image on the window. The image of
+ * a call shows the noise of the previous call, the noise of this call is
+ * computed on the worker threads until the next one. If the pixels of
+ * the images can't be written directly, the tiles are drawn by the
+ * calling thread.
+ *
  * @param time_s Current time in seconds for animation.
  * @param palette_i Index of the color palette to use.
  */
 void draw_background(float time_s, int palette_i);
 
+/**
+ * @brief Stops the threads and frees the buffers of the menu background.
+ */
+void free_background();
+
+/**
+ * @brief Draws a title centered in the top band of the window, white
+ * with a black outline.
+ *
+ * The title is rendered once in the text cache (text_cache.h).
+ *
+ * @param title Text of the title.
+ * @param font Font of the title.
+ */
+void draw_menu_title(const char *title, MLV_Font *font);
+
+/**
+ * @brief Draws a white text centered in a transparent box.
+ *
+ * The box is laid out once in the text cache (text_cache.h).
+ *
+ * @param x X position of the box.
+ * @param y Y position of the box.
+ * @param width Width of the box.
+ * @param height Height of the box.
+ * @param text Text of the box.
+ * @param font Font of the text.
+ */
+void draw_menu_text_box(int x, int y, int width, int height, const char *text, MLV_Font *font);
+
 /* =========================================================
  * Snake skin preview / selection
  * ========================================================= */
 
 /**
- * @brief Loads a snake skin image for the menu preview.
+ * @brief Moves the preview of a skin dialog to another skin.
+ *
+ * The preview of the new skin is borrowed from the skin cache, the one of
+ * the old skin is given back, and the neighbours of the new skin are
+ * prefetched.
  *
- * @param index Index of the snake skin.
- * @param output Pointer to the MLV_Image* that will hold the loaded sprite.
+ * @param[in] index Index of the skin shown, whose preview is borrowed.
+ * @param[in] step Move in the carousel (-1 or 1), wrapping around.
+ * @param[out] preview Preview of the new skin, borrowed.
+ * @return int Index of the new skin.
  */
-void load_snake_skin_view(int index, MLV_Image **output);
+int change_skin_preview(int index, int step, MLV_Image **preview);
 
 /**
  * @brief Opens solo player skin selection dialog.
  *
- * @param config Pointer to the game configuration for the first player.
+ * @param view Render data of the game, the first player skin is loaded in it.
+ *
+ * @details
+ * Clicks and keys are handled as soon as they arrive, while waiting for
+ * the next frame of the animated background.
  */
-void select_solo_skin_dialog(GameConfig *config);
+void select_solo_skin_dialog(GameView *view);
 
 /**
  * @brief Opens two-player skin selection dialog.
  *
- * @param config Pointer to the game configuration for both players.
+ * @param view Render data of the game, both players skins are loaded in it.
+ *
+ * @details
+ * Clicks and keys are handled as soon as they arrive, while waiting for
+ * the next frame of the animated background.
  */
-void select_duo_skin_dialog(GameConfig *config);
+void select_duo_skin_dialog(GameView *view);
 
 /* =========================================================
  * Menu screens
@@ -119,20 +178,36 @@ void update_snake_square_turn(Snake* s, int x_min, int y_min, int x_max, int y_m
  *
  * @param current Current palette index.
  * @param palette_count Total number of palettes available.
+ * @param random Generator of the menu.
  * @return int New palette index.
  */
-int pick_new_palette(int current, int palette_count);
+int pick_new_palette(int current, int palette_count, GameRandom *random);
+
+/**
+ * @brief Returns the button under the mouse.
+ *
+ * Menus redraw their buttons only when this index changes.
+ *
+ * @param buttons Buttons of the menu.
+ * @param count Number of buttons.
+ * @param mouse_p Position of the mouse.
+ * @return int Index of the first button under the mouse, -1 if none.
+ */
+int get_hovered_button(MLV_Button **buttons, int count, vector2i *mouse_p);
 
 
 /**
  * @brief Displays the in-game pause menu.
  *
  * @param[in,out] config Pointer to the current GameConfig.
+ * @param[in,out] view Render data of the current game.
  *
  * @details
  * Provides buttons to continue, save, load, or stop the game.
  * Updates the game state according to the player's choice.
+ * The menu sleeps until an input and is drawn again only when the
+ * hovered button changes, so a paused game uses almost no CPU.
  */
-void show_menu(GameConfig *config);
+void show_menu(GameConfig *config, GameView *view);
 
 #endif /* _GAME_MENU_H */
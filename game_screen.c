@@ -5,67 +5,51 @@ void init_game_screen() {
     MLV_create_window("snake", "Snake game", SCREEN_WIDTH, SCREEN_HEIGH);
 }
 
-void delete_image_part(MLV_Image *image, int x, int y, int width, int height) {
-    int i, j;
-
-    for (i = y; i < height; i++) {
-        for (j = x; j < width; j++) {
-            MLV_set_pixel_on_image(j, i, MLV_rgba(0, 0, 0, 0), image);
-        }
-    }
-}
-
-void custom_rotate_right_image(MLV_Image *source) {
-    int height, width, i, j, r, g, b, a;
-    MLV_Image *tmp;
-
-    MLV_get_image_size(source, &width, &height);
-    tmp = MLV_copy_image(source);
-
-    for (i = 0; i < height; i++) {
-        for (j = 0; j < width; j++) {
-            MLV_get_pixel_on_image(tmp, j, i, &r, &g, &b, &a);
-            MLV_set_pixel_on_image(i, j, MLV_rgba(r, g, b, a), source);
-        }
-    }
-
-    MLV_free_image(tmp);
-}
-
-void draw_straigth_body_part(SnakeSprite *sprite, vector2i delta_p, int x, int y, int index, float shift) {
+void draw_straigth_body_part(SnakeSprite *sprite, vector2i delta_p, int x, int y, int index, float shift, GameScreen *screen) {
+    SPRITE_ORIENTATION orientation;
     MLV_Image *image;
-
-    image = MLV_copy_image(sprite->straight_body);
-
-    /* cut part next to head */
-    if (index == 1 &&  delta_p.x * delta_p.x <= 4 && delta_p.y * delta_p.y <= 4) {
-        delete_image_part(image,
-                          GRID_CELL_DRAW_SIZE * (shift + 0.22f > 1.f ? 1.f : shift + 0.22f), 0,
-                          GRID_CELL_DRAW_SIZE, GRID_CELL_DRAW_SIZE);
-    }
+    int cut, size;
 
     /* bottom rotation */
-    if (delta_p.y == 2 || delta_p.y < -2) {
-        custom_rotate_right_image(image);
-    }
+    if (delta_p.y == 2 || delta_p.y < -2)
+        orientation = SPRITE_ORIENTATION_BOTTOM;
     /* top rotation */
-    else if (delta_p.y == -2 || delta_p.y > 2) {
-        custom_rotate_right_image(image);
-        MLV_horizontal_image_mirror(image);
-    }
+    else if (delta_p.y == -2 || delta_p.y > 2)
+        orientation = SPRITE_ORIENTATION_TOP;
     /* left rotation */
-    else if (delta_p.x == -2 || delta_p.x > 2) {
-        MLV_vertical_image_mirror(image);
+    else if (delta_p.x == -2 || delta_p.x > 2)
+        orientation = SPRITE_ORIENTATION_LEFT;
+    else
+        orientation = SPRITE_ORIENTATION_RIGHT;
+
+    image = sprite->straight_body[orientation];
+
+    /* cut part next to head: only the part behind the head is drawn */
+    if (index == 1 &&  delta_p.x * delta_p.x <= 4 && delta_p.y * delta_p.y <= 4) {
+        size = GRID_CELL_DRAW_SIZE;
+        cut = size * (shift + 0.22f > 1.f ? 1.f : shift + 0.22f);
+
+        switch (orientation) {
+        case SPRITE_ORIENTATION_BOTTOM:
+            screen_draw_partial_image(screen, image, 0, 0, size, cut, x, y);
+            break;
+        case SPRITE_ORIENTATION_TOP:
+            screen_draw_partial_image(screen, image, 0, size - cut, size, cut, x, y + size - cut);
+            break;
+        case SPRITE_ORIENTATION_LEFT:
+            screen_draw_partial_image(screen, image, size - cut, 0, cut, size, x + size - cut, y);
+            break;
+        default:
+            screen_draw_partial_image(screen, image, 0, 0, cut, size, x, y);
+            break;
+        }
+    } else {
+        screen_draw_image(screen, image, x, y);
     }
-    
-    MLV_draw_image(image, x, y);
-    MLV_free_image(image);
 }
 
-void draw_rotated_body_part(SnakeSprite *sprite, vector2i delta_p, int x, int y, int up) {
-    MLV_Image *image;
-
-    image = MLV_copy_image(sprite->rotate_body);
+void draw_rotated_body_part(SnakeSprite *sprite, vector2i delta_p, int x, int y, int up, GameScreen *screen) {
+    SPRITE_MIRROR mirror;
 
     if (!up) {
         delta_p.x *= -1;
@@ -73,19 +57,19 @@ void draw_rotated_body_part(SnakeSprite *sprite, vector2i delta_p, int x, int y,
     }
 
     if        ((delta_p.x == -1 || delta_p.x >  1) && (delta_p.y == -1 || delta_p.y >  1)) {
-        MLV_vertical_image_mirror(image);
+        mirror = SPRITE_MIRROR_VERTICAL;
     } else if ((delta_p.x ==  1 || delta_p.x < -1) && (delta_p.y ==  1 || delta_p.y < -1)) {
-        MLV_horizontal_image_mirror(image);
+        mirror = SPRITE_MIRROR_HORIZONTAL;
     } else if ((delta_p.x == -1 || delta_p.x >  1) && (delta_p.y ==  1 || delta_p.y < -1)) {
-        MLV_vertical_image_mirror(image);
-        MLV_horizontal_image_mirror(image);
+        mirror = SPRITE_MIRROR_BOTH;
+    } else {
+        mirror = SPRITE_MIRROR_NONE;
     }
 
-    MLV_draw_image(image, x, y);
-    MLV_free_image(image);
+    screen_draw_image(screen, sprite->rotate_body[mirror], x, y);
 }
 
-void draw_snake_body(Snake *snake, float shift) {
+void draw_snake_body(Snake *snake, SnakeView *view, float shift, GameScreen *screen) {
     size_t i, snake_size;
     int s_x, s_y;
     vector2i *tmp_p, *back_p, *next_p, delta_p;
@@ -102,7 +86,7 @@ void draw_snake_body(Snake *snake, float shift) {
             s_x = SCREEN_X_PADDING + GRID_CELL_DRAW_SIZE * tmp_p->x;
             s_y = SCREEN_Y_PADDING + GRID_CELL_DRAW_SIZE * tmp_p->y;
             
-            MLV_draw_filled_rectangle(s_x, s_y, GRID_CELL_DRAW_SIZE, GRID_CELL_DRAW_SIZE, MLV_COLOR_GRAY);
+            screen_draw_filled_rectangle(screen, s_x, s_y, GRID_CELL_DRAW_SIZE, GRID_CELL_DRAW_SIZE, MLV_COLOR_GRAY);
         }
     /* Live state */
     } else if (snake_size > 2) {
@@ -119,10 +103,10 @@ void draw_snake_body(Snake *snake, float shift) {
             
             /* draw straight part */
             if (delta_p.x == 0 || delta_p.y == 0) {
-                draw_straigth_body_part(&snake->sprite, delta_p, s_x, s_y, i, shift);
+                draw_straigth_body_part(&view->sprite, delta_p, s_x, s_y, i, shift, screen);
             /* draw rotated part */
             } else {
-                draw_rotated_body_part(&snake->sprite, delta_p, s_x, s_y, back_p->y != tmp_p->y);
+                draw_rotated_body_part(&view->sprite, delta_p, s_x, s_y, back_p->y != tmp_p->y, screen);
             }
             
         }
@@ -131,16 +115,13 @@ void draw_snake_body(Snake *snake, float shift) {
 }
 
 
-void draw_snake_head(Snake *snake, float shift) {
+void draw_snake_head(Snake *snake, SnakeView *view, float shift, GameScreen *screen) {
     vector2i *head_p;
     int s_x, s_y;
     SnakeDirection direction;
-    MLV_Image *image;
 
     if (snake->is_alive) {
 
-        image = MLV_copy_image(snake->sprite.head);
-    
         head_p = get_snake_head_position(snake);
 
         s_x = SCREEN_X_PADDING + GRID_CELL_DRAW_SIZE * head_p->x;
@@ -151,31 +132,25 @@ void draw_snake_head(Snake *snake, float shift) {
         switch(direction) {
         case SNAKE_DIRECTION_LEFT:
             s_x += GRID_CELL_DRAW_SIZE * (1.f - shift);
-            MLV_vertical_image_mirror(image);
             break;
         case SNAKE_DIRECTION_RIGTH:
             s_x += GRID_CELL_DRAW_SIZE * (shift - 1.f) + 1;
             break;
         case SNAKE_DIRECTION_TOP:
             s_y += (1 - shift) * GRID_CELL_DRAW_SIZE;
-            custom_rotate_right_image(image);
-            MLV_horizontal_image_mirror(image);
             break;
         case SNAKE_DIRECTION_BOTTOM:
             s_y += GRID_CELL_DRAW_SIZE * (shift - 1.f) + 1;
-            custom_rotate_right_image(image);
             break;
         default:
             break;
         }
 
-        MLV_draw_image(image, s_x, s_y);
-
-        MLV_free_image(image);
+        screen_draw_image(screen, view->sprite.head[get_sprite_orientation(direction)], s_x, s_y);
     }
 }
 
-void draw_score(unsigned int score) {
+void draw_score(unsigned int score, MLV_Image *image) {
     int i;
     char text[17];
 
@@ -188,17 +163,17 @@ void draw_score(unsigned int score) {
         score /= 10;
     }
 
-    MLV_draw_text(5, 5, text, MLV_COLOR_BLACK);
+    MLV_draw_text_on_image(5, 5, text, MLV_COLOR_BLACK, image);
 }
 
-void draw_score_list(unsigned int *score_list) {
+void draw_score_list(unsigned int *score_list, MLV_Image *image) {
     int i, j;
     unsigned int value;
-    char text[13];
+    char text[14];
 
     for (i = 0; i < GAME_SCORE_LIST_SIZE && score_list[i] > 0; i++) {
 
-        strcpy(text, "  .         ");
+        strcpy(text, "  .          ");
         if (i == 9) text[0] = '1';
         text[1] = '0' + (i + 1) % 10;
 
@@ -208,38 +183,38 @@ void draw_score_list(unsigned int *score_list) {
             value /= 10;
         }
         
-        MLV_draw_text(5, i * 20 + 200, text, MLV_COLOR_BLACK);
+        MLV_draw_text_on_image(5, i * 20 + 200, text, MLV_COLOR_BLACK, image);
     }
 }
 
-void draw_apple(GameConfig *config, GameObject *object) {
+void draw_apple(GameConfig *config, GameObject *object, GameObjectView *view, GameScreen *screen) {
     int x, y;
 
     x = SCREEN_X_PADDING + GRID_CELL_DRAW_SIZE * object->pos.x;
     y = SCREEN_Y_PADDING + GRID_CELL_DRAW_SIZE * object->pos.y;
 
-    if (object->sprite == NULL) {
-        MLV_draw_filled_rectangle(x, y, GRID_CELL_DRAW_SIZE, GRID_CELL_DRAW_SIZE, object->color);
+    if (view->sprite == NULL) {
+        screen_draw_filled_rectangle(screen, x, y, GRID_CELL_DRAW_SIZE, GRID_CELL_DRAW_SIZE, view->color);
     } else {
         y += sinf(config->time / 60.f) * GRID_CELL_DRAW_SIZE / 10.f;
-        MLV_draw_image(object->sprite, x, y);
+        screen_draw_image(screen, view->sprite, x, y);
     }
 }
 
-void draw_portal(GameObject *object) {
+void draw_portal(GameObject *object, GameObjectView *view, GameScreen *screen) {
     int x, y;
 
     x = SCREEN_X_PADDING + GRID_CELL_DRAW_SIZE * object->pos.x;
     y = SCREEN_Y_PADDING + GRID_CELL_DRAW_SIZE * object->pos.y;
 
-    if (object->sprite == NULL) {
-        MLV_draw_filled_rectangle(x, y, GRID_CELL_DRAW_SIZE, GRID_CELL_DRAW_SIZE, object->color);
+    if (view->sprite == NULL) {
+        screen_draw_filled_rectangle(screen, x, y, GRID_CELL_DRAW_SIZE, GRID_CELL_DRAW_SIZE, view->color);
     } else {
-        MLV_draw_image(object->sprite, x, y);
+        screen_draw_image(screen, view->sprite, x, y);
     }
 }
 
-void draw_bottoms_game_objects(GameConfig *config) {
+void draw_bottoms_game_objects(GameConfig *config, GameView *view, GameScreen *screen) {
     GameObject* object;
     int i;
 
@@ -248,7 +223,7 @@ void draw_bottoms_game_objects(GameConfig *config) {
 
         switch (object->type) {
         case GAME_OBJECT_APPLE:
-            draw_apple(config, object);
+            draw_apple(config, object, &view->objects[i], screen);
             break;
         default:
             break;
@@ -256,7 +231,7 @@ void draw_bottoms_game_objects(GameConfig *config) {
     }
 }
 
-void draw_uppers_game_objects(GameConfig *config) {
+void draw_uppers_game_objects(GameConfig *config, GameView *view, GameScreen *screen) {
     GameObject* object;
     int i;
 
@@ -265,7 +240,7 @@ void draw_uppers_game_objects(GameConfig *config) {
 
         switch (object->type) {
         case GAME_OBJECT_PORTAL:
-            draw_portal(object);
+            draw_portal(object, &view->objects[i], screen);
             break;
         default:
             break;
@@ -273,42 +248,412 @@ void draw_uppers_game_objects(GameConfig *config) {
     }
 }
 
-void draw_game(GameConfig *config, unsigned int *score_list, float shift) {
+/*
+ * Rectangle of the board on the window, inside its border.
+ */
+static ScreenRect get_board_rect() {
+    ScreenRect res;
+
+    res.x = SCREEN_X_PADDING + 1;
+    res.y = SCREEN_Y_PADDING + 1;
+    res.width = GRID_SIZE * GRID_CELL_DRAW_SIZE - 2;
+    res.height = GRID_SIZE * GRID_CELL_DRAW_SIZE - 2;
+
+    return res;
+}
+
+/*
+ * Rectangle of the score panel on the window.
+ */
+static ScreenRect get_score_rect() {
+    ScreenRect res;
+
+    res.x = 0;
+    res.y = 0;
+    res.width = SCREEN_X_PADDING;
+    res.height = SCREEN_Y_PADDING;
+
+    return res;
+}
+
+/*
+ * Intersection of two rectangles, returns 0 if it is empty.
+ */
+static int intersect_screen_rect(const ScreenRect *a, const ScreenRect *b, ScreenRect *res) {
+    int right, bottom;
+
+    res->x = a->x > b->x ? a->x : b->x;
+    res->y = a->y > b->y ? a->y : b->y;
+    right = a->x + a->width < b->x + b->width ? a->x + a->width : b->x + b->width;
+    bottom = a->y + a->height < b->y + b->height ? a->y + a->height : b->y + b->height;
+
+    res->width = right - res->x;
+    res->height = bottom - res->y;
+
+    return res->width > 0 && res->height > 0;
+}
+
+/*
+ * Adds a damaged rectangle, the last one grows when the list is full.
+ */
+static void add_screen_damage(GameScreen *screen, const ScreenRect *rect) {
+    ScreenRect *last;
+    int right, bottom;
+
+    if (screen->damages_count < SCREEN_MAX_DAMAGES) {
+        screen->damages[screen->damages_count] = *rect;
+        screen->damages_count++;
+    } else {
+        last = &screen->damages[SCREEN_MAX_DAMAGES - 1];
+
+        right = last->x + last->width > rect->x + rect->width ? last->x + last->width : rect->x + rect->width;
+        bottom = last->y + last->height > rect->y + rect->height ? last->y + last->height : rect->y + rect->height;
+
+        last->x = last->x < rect->x ? last->x : rect->x;
+        last->y = last->y < rect->y ? last->y : rect->y;
+        last->width = right - last->x;
+        last->height = bottom - last->y;
+    }
+}
+
+/*
+ * Records a draw of the current frame, clipped to the board.
+ */
+static void add_screen_draw(GameScreen *screen, const MLV_Image *image, MLV_Color color,
+                            int source_x, int source_y, int x, int y, int width, int height) {
+    ScreenRect area, board, rect;
+    ScreenDraw *draw;
+    int *count;
+
+    area.x = x;
+    area.y = y;
+    area.width = width;
+    area.height = height;
+    board = get_board_rect();
+    count = &screen->draws_count[screen->current];
+
+    if (*count < SCREEN_MAX_DRAWS && intersect_screen_rect(&area, &board, &rect)) {
+        draw = &screen->draws[screen->current][*count];
+
+        draw->image = image;
+        draw->color = image == NULL ? color : 0;
+        draw->source_x = source_x + rect.x - x;
+        draw->source_y = source_y + rect.y - y;
+        draw->rect = rect;
+
+        (*count)++;
+    }
+}
+
+/*
+ * Returns 1 if two draws paint the same pixels.
+ */
+static int is_same_screen_draw(const ScreenDraw *a, const ScreenDraw *b) {
+    return a->image == b->image && a->color == b->color &&
+           a->source_x == b->source_x && a->source_y == b->source_y &&
+           a->rect.x == b->rect.x && a->rect.y == b->rect.y &&
+           a->rect.width == b->rect.width && a->rect.height == b->rect.height;
+}
+
+/*
+ * Slot of a draw in the hash table.
+ */
+static int hash_screen_draw(const ScreenDraw *draw) {
+    unsigned long res;
+
+    res = (unsigned long) (size_t) draw->image;
+    res = res * 31 + draw->color;
+    res = res * 31 + (unsigned long) draw->source_x;
+    res = res * 31 + (unsigned long) draw->source_y;
+    res = res * 31 + (unsigned long) draw->rect.x;
+    res = res * 31 + (unsigned long) draw->rect.y;
+    res = res * 31 + (unsigned long) draw->rect.width;
+    res = res * 31 + (unsigned long) draw->rect.height;
+
+    return (int) ((res ^ (res >> 16)) & (SCREEN_DRAWS_TABLE_SIZE - 1));
+}
+
+/*
+ * Damages the rectangles of the draws which are only in the previous or
+ * only in the current frame. The previous draws are put in a hash table,
+ * so the comparison is linear in the number of draws.
+ */
+static void damage_screen_changes(GameScreen *screen) {
+    ScreenDraw *previous, *current, *draw;
+    int previous_count, current_count, i, slot, found;
+
+    previous = screen->draws[1 - screen->current];
+    previous_count = screen->draws_count[1 - screen->current];
+    current = screen->draws[screen->current];
+    current_count = screen->draws_count[screen->current];
+
+    for (i = 0; i < SCREEN_DRAWS_TABLE_SIZE; i++)
+        screen->table[i] = 0;
+
+    for (i = 0; i < previous_count; i++) {
+        slot = hash_screen_draw(previous + i);
+        while (screen->table[slot] != 0)
+            slot = (slot + 1) & (SCREEN_DRAWS_TABLE_SIZE - 1);
+
+        screen->table[slot] = i + 1;
+        screen->matched[i] = 0;
+    }
 
-    MLV_clear_window(MLV_COLOR_WHITE);
+    for (i = 0; i < current_count; i++) {
+        draw = current + i;
+        slot = hash_screen_draw(draw);
+        found = 0;
 
-    draw_bottoms_game_objects(config);
+        /* a previous draw matches at most one current draw */
+        while (screen->table[slot] != 0 && !found) {
+            found = !screen->matched[screen->table[slot] - 1] &&
+                    is_same_screen_draw(previous + screen->table[slot] - 1, draw);
 
-    draw_snake_body(&config->first_player, shift);
-    draw_snake_head(&config->first_player, shift);
+            if (found)
+                screen->matched[screen->table[slot] - 1] = 1;
+            else
+                slot = (slot + 1) & (SCREEN_DRAWS_TABLE_SIZE - 1);
+        }
 
-    if (config->game_mode == GAME_TWO_PLAYER_MODE) {
-        draw_snake_body(&config->second_player, shift);
-        draw_snake_head(&config->second_player, shift);
+        if (!found)
+            add_screen_damage(screen, &draw->rect);
     }
 
-    draw_uppers_game_objects(config);
-
-    MLV_draw_filled_rectangle(0, 0, SCREEN_WIDTH, SCREEN_Y_PADDING, MLV_COLOR_WHITE);
-    MLV_draw_filled_rectangle(0, SCREEN_Y_PADDING + GRID_SIZE * GRID_CELL_DRAW_SIZE, 
-                              SCREEN_WIDTH, SCREEN_Y_PADDING, 
-                              MLV_COLOR_WHITE);
-    MLV_draw_filled_rectangle(0, 0, SCREEN_X_PADDING, SCREEN_HEIGH, MLV_COLOR_WHITE);
-    MLV_draw_filled_rectangle(SCREEN_X_PADDING + GRID_CELL_DRAW_SIZE * GRID_SIZE, 0, 
-                              SCREEN_WIDTH, SCREEN_HEIGH, MLV_COLOR_WHITE);
-
-    /* Border */
-    MLV_draw_rectangle(SCREEN_X_PADDING, SCREEN_Y_PADDING,
-                       GRID_SIZE * GRID_CELL_DRAW_SIZE,
-                       GRID_SIZE * GRID_CELL_DRAW_SIZE,
-                       MLV_COLOR_BLACK);
-
-    if (config->game_mode != GAME_TWO_PLAYER_MODE) {
-        draw_score(config->score);
-        draw_score_list(score_list);
+    for (i = 0; i < previous_count; i++) {
+        if (!screen->matched[i])
+            add_screen_damage(screen, &previous[i].rect);
     }
+}
+
+/*
+ * Paints the part of a recorded draw inside a rectangle.
+ */
+static void paint_screen_draw(OutputStrategy *output, const ScreenDraw *draw, const ScreenRect *clip) {
+    ScreenRect part;
+
+    if (intersect_screen_rect(&draw->rect, clip, &part)) {
+        if (draw->image == NULL) {
+            output->draw_filled_rectangle(output, part.x, part.y, part.width, part.height, draw->color);
+        } else {
+            output->draw_image(output, draw->image,
+                               draw->source_x + part.x - draw->rect.x,
+                               draw->source_y + part.y - draw->rect.y,
+                               part.width, part.height, part.x, part.y);
+        }
+    }
+}
+
+/*
+ * Renders the background layer: the empty board, its border and, if
+ * shown, the high score list.
+ */
+static void render_screen_background(GameScreen *screen) {
+    int i;
+
+    MLV_draw_filled_rectangle_on_image(0, 0, SCREEN_WIDTH, SCREEN_HEIGH, MLV_COLOR_WHITE, screen->background);
+
+    MLV_draw_rectangle_on_image(SCREEN_X_PADDING, SCREEN_Y_PADDING,
+                                GRID_SIZE * GRID_CELL_DRAW_SIZE,
+                                GRID_SIZE * GRID_CELL_DRAW_SIZE,
+                                MLV_COLOR_BLACK, screen->background);
+
+    if (screen->show_scores)
+        draw_score_list(screen->score_list, screen->background);
+
+    for (i = 0; i < GAME_SCORE_LIST_SIZE; i++)
+        screen->drawn_score_list[i] = screen->score_list[i];
+    screen->drawn_show_scores = screen->show_scores;
+
+    get_output_strategy()->forget_image(get_output_strategy(), screen->background);
+}
+
+/*
+ * Renders the score panel layer.
+ */
+static void render_screen_score_panel(GameScreen *screen, unsigned int score) {
+    ScreenRect rect;
+
+    rect = get_score_rect();
+    MLV_draw_filled_rectangle_on_image(0, 0, rect.width, rect.height, MLV_COLOR_WHITE, screen->score_panel);
+
+    draw_score(score, screen->score_panel);
+    screen->score = score;
+
+    get_output_strategy()->forget_image(get_output_strategy(), screen->score_panel);
+}
+
+/*
+ * Returns 1 if the background layer must be rendered again.
+ */
+static int is_screen_background_outdated(GameScreen *screen) {
+    int i, res;
+
+    res = screen->show_scores != screen->drawn_show_scores;
+    for (i = 0; i < GAME_SCORE_LIST_SIZE && !res && screen->show_scores; i++)
+        res = screen->score_list[i] != screen->drawn_score_list[i];
+
+    return res;
+}
+
+void init_game_screen_layers(GameScreen *screen) {
+    ScreenRect rect;
+    int i;
+
+    rect = get_score_rect();
+
+    screen->background = MLV_create_image(SCREEN_WIDTH, SCREEN_HEIGH);
+    screen->score_panel = MLV_create_image(rect.width, rect.height);
+
+    for (i = 0; i < GAME_SCORE_LIST_SIZE; i++)
+        screen->score_list[i] = 0;
+    screen->show_scores = 0;
+
+    render_screen_background(screen);
+    render_screen_score_panel(screen, 0);
+
+    reset_game_screen(screen);
+}
+
+void free_game_screen_layers(GameScreen *screen) {
+    free_output_image(screen->background);
+    free_output_image(screen->score_panel);
+
+    screen->background = NULL;
+    screen->score_panel = NULL;
+}
+
+void reset_game_screen(GameScreen *screen) {
+    screen->draws_count[0] = 0;
+    screen->draws_count[1] = 0;
+    screen->current = 0;
+    screen->damages_count = 0;
+    screen->full_repaint = 1;
+}
+
+void screen_draw_image(GameScreen *screen, const MLV_Image *image, int x, int y) {
+    OutputStrategy *output;
+    int width, height;
+
+    MLV_get_image_size(image, &width, &height);
+
+    if (screen == NULL) {
+        output = get_output_strategy();
+        output->draw_image(output, image, 0, 0, width, height, x, y);
+    } else {
+        add_screen_draw(screen, image, 0, 0, 0, x, y, width, height);
+    }
+}
+
+void screen_draw_partial_image(GameScreen *screen, const MLV_Image *image,
+                               int source_x, int source_y, int width, int height,
+                               int x, int y) {
+    OutputStrategy *output;
+
+    if (screen == NULL) {
+        output = get_output_strategy();
+        output->draw_image(output, image, source_x, source_y, width, height, x, y);
+    } else {
+        add_screen_draw(screen, image, 0, source_x, source_y, x, y, width, height);
+    }
+}
+
+void screen_draw_filled_rectangle(GameScreen *screen, int x, int y, int width, int height, MLV_Color color) {
+    OutputStrategy *output;
+
+    if (screen == NULL) {
+        output = get_output_strategy();
+        output->draw_filled_rectangle(output, x, y, width, height, color);
+    } else {
+        add_screen_draw(screen, NULL, color, 0, 0, x, y, width, height);
+    }
+}
+
+void draw_game(GameConfig *config, GameView *view, GameScreen *screen, unsigned int *score_list, float shift) {
+    OutputStrategy *output;
+    ScreenRect rect;
+    ScreenDraw *draws;
+    int i, j, count;
+
+    output = get_output_strategy();
+
+    /* static layers */
+    screen->show_scores = config->game_mode != GAME_TWO_PLAYER_MODE;
+    for (i = 0; i < GAME_SCORE_LIST_SIZE; i++)
+        screen->score_list[i] = score_list[i];
+
+    begin_profiler_stage(PROFILER_STAGE_HUD);
+    if (is_screen_background_outdated(screen)) {
+        render_screen_background(screen);
+        screen->full_repaint = 1;
+    }
+    end_profiler_stage(PROFILER_STAGE_HUD);
+
+    /* record the draws of the frame */
+    screen->current = 1 - screen->current;
+    screen->draws_count[screen->current] = 0;
+    screen->damages_count = 0;
+
+    begin_profiler_stage(PROFILER_STAGE_OBJECTS);
+    draw_bottoms_game_objects(config, view, screen);
+    end_profiler_stage(PROFILER_STAGE_OBJECTS);
+
+    for (i = 0; i < config->players_count && i < GAME_VIEW_PLAYERS_NUMBER; i++) {
+        begin_profiler_stage(PROFILER_STAGE_BODY);
+        draw_snake_body(&config->snakes[i], &view->players[i], shift, screen);
+        end_profiler_stage(PROFILER_STAGE_BODY);
+
+        begin_profiler_stage(PROFILER_STAGE_HEAD);
+        draw_snake_head(&config->snakes[i], &view->players[i], shift, screen);
+        end_profiler_stage(PROFILER_STAGE_HEAD);
+    }
+
+    begin_profiler_stage(PROFILER_STAGE_OBJECTS);
+    draw_uppers_game_objects(config, view, screen);
+    end_profiler_stage(PROFILER_STAGE_OBJECTS);
+
+    begin_profiler_stage(PROFILER_STAGE_REPAINT);
+
+    draws = screen->draws[screen->current];
+    count = screen->draws_count[screen->current];
+
+    /* repaint what changed, the background layer restores the board under it */
+    if (screen->full_repaint) {
+        output->draw_image(output, screen->background, 0, 0, SCREEN_WIDTH, SCREEN_HEIGH, 0, 0);
+
+        rect = get_board_rect();
+        for (i = 0; i < count; i++)
+            paint_screen_draw(output, draws + i, &rect);
+    } else {
+        damage_screen_changes(screen);
+
+        for (i = 0; i < screen->damages_count; i++) {
+            rect = screen->damages[i];
+            output->draw_image(output, screen->background, rect.x, rect.y, rect.width, rect.height, rect.x, rect.y);
+
+            for (j = 0; j < count; j++)
+                paint_screen_draw(output, draws + j, &rect);
+        }
+    }
+
+    end_profiler_stage(PROFILER_STAGE_REPAINT);
+
+    begin_profiler_stage(PROFILER_STAGE_HUD);
+    if (screen->show_scores && (screen->full_repaint || screen->score != config->score)) {
+        if (screen->score != config->score)
+            render_screen_score_panel(screen, config->score);
+
+        rect = get_score_rect();
+        output->draw_image(output, screen->score_panel, 0, 0, rect.width, rect.height, rect.x, rect.y);
+    }
+    end_profiler_stage(PROFILER_STAGE_HUD);
+
+    screen->full_repaint = 0;
+
+    draw_frame_profiler_overlay(output);
 
-    MLV_actualise_window();
+    begin_profiler_stage(PROFILER_STAGE_PRESENT);
+    output->present(output);
+    end_profiler_stage(PROFILER_STAGE_PRESENT);
 }
 
 void free_game_screen() {
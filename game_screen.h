@@ -5,12 +5,105 @@
  * This file provides functions to initialize the game window,
  * draw the grid, snake (head, body, tail), apple, and update
  * the screen. Also includes cleanup function to free the window.
+ *
+ * ## Damage tracking
+ * The drawing functions take a GameScreen. With NULL they draw at once on
+ * the window (as the menus do). Otherwise they only record the draw,
+ * clipped to the board, in the draw list of the current frame.
+ *
+ * draw_game() then compares the draw list with the one of the previous
+ * frame: a draw found in only one of them damages its rectangle. Only
+ * the damaged rectangles are cleared and repainted with the draws which
+ * cross them, and the score panel only when the score changes. Between
+ * two ticks, that is the head, the neck and the apples, whatever the
+ * length of the snakes.
+ *
+ * ## Static layers
+ * The empty board with its border and the high score list are rendered
+ * once in the background image, the score in the score panel image. A
+ * damaged rectangle is restored with a part of the background, the score
+ * panel is blitted when the score changes, and the layers are rendered
+ * again only when the score or the score list changes. The draws are
+ * clipped inside the border, which is never drawn over.
+ *
+ * ## Output
+ * Nothing is painted with MLV directly: the window is painted through the
+ * current OutputStrategy (output_strategy.h), which may as well be an
+ * offscreen framebuffer. The layers are forgotten by the strategy every
+ * time they are rendered again.
+ *
+ * MLV_actualise_window() always presents the whole window: the window
+ * keeps its pixels between frames and only the damaged rectangles are
+ * painted on it. After anything else was drawn on the window (a menu),
+ * reset_game_screen() makes the next frame repaint everything.
  */
+#ifndef _GAME_SCREEN_H
+#define _GAME_SCREEN_H
 
 #include <MLV/MLV_all.h>
 #include <string.h>
 #include <math.h>
 #include "game_config.h"
+#include "game_view.h"
+#include "output_strategy.h"
+#include "frame_profiler.h"
+
+#define SCREEN_MAX_DRAWS ( 2 * GRID_SIZE * GRID_SIZE + 2 * GAME_OBJECTS_NUMBER ) /**< Draws recorded in one frame */
+#define SCREEN_DRAWS_TABLE_SIZE 4096 /**< Size of the hash table comparing two frames (power of 2, at least 2 * SCREEN_MAX_DRAWS) */
+#define SCREEN_MAX_DAMAGES 32        /**< Damaged rectangles of one frame, the next ones are merged */
+
+#if (SCREEN_DRAWS_TABLE_SIZE < 2 * SCREEN_MAX_DRAWS)
+#error "SCREEN_DRAWS_TABLE_SIZE must be at least 2 * SCREEN_MAX_DRAWS"
+#endif
+
+/**
+ * @struct ScreenRect
+ * @brief Rectangle of the window, in pixels.
+ */
+typedef struct {
+    int x;      /**< Left column. */
+    int y;      /**< Top row. */
+    int width;  /**< Width, greater than 0. */
+    int height; /**< Height, greater than 0. */
+} ScreenRect;
+
+/**
+ * @struct ScreenDraw
+ * @brief One recorded draw: an image part or a filled rectangle.
+ */
+typedef struct {
+    const MLV_Image *image; /**< Image drawn, NULL for a filled rectangle. */
+    MLV_Color color;        /**< Color of a filled rectangle. */
+    int source_x;           /**< Column of the image drawn at rect.x. */
+    int source_y;           /**< Row of the image drawn at rect.y. */
+    ScreenRect rect;        /**< Rectangle covered on the window. */
+} ScreenDraw;
+
+/**
+ * @struct GameScreen
+ * @brief Draw lists of the last two frames and damage of the game screen.
+ */
+typedef struct {
+    ScreenDraw draws[2][SCREEN_MAX_DRAWS];   /**< Draw lists of the current and of the previous frame. */
+    int draws_count[2];                      /**< Number of draws of each list. */
+    int current;                             /**< Index of the list of the current frame. */
+
+    int table[SCREEN_DRAWS_TABLE_SIZE];      /**< Hash table of the previous draws (index + 1, 0 if empty). */
+    unsigned char matched[SCREEN_MAX_DRAWS]; /**< Previous draws found again in the current frame. */
+
+    ScreenRect damages[SCREEN_MAX_DAMAGES];  /**< Damaged rectangles of the frame. */
+    int damages_count;                       /**< Number of damaged rectangles. */
+
+    int full_repaint;                        /**< 1 if the next frame repaints the whole window. */
+
+    MLV_Image *background;                   /**< Static layer: empty board, border and high scores. */
+    MLV_Image *score_panel;                  /**< Static layer: the score. */
+    unsigned int score;                      /**< Score rendered in score_panel. */
+    unsigned int score_list[GAME_SCORE_LIST_SIZE];       /**< High scores to show. */
+    unsigned int drawn_score_list[GAME_SCORE_LIST_SIZE]; /**< High scores rendered in background. */
+    int show_scores;                         /**< 1 if the scores are shown (not in two player mode). */
+    int drawn_show_scores;                   /**< show_scores when background was rendered. */
+} GameScreen;
 
 /**
  * @brief Initializes the game window.
@@ -18,25 +111,66 @@
 void init_game_screen();
 
 /**
- * @brief Clears a rectangular part of an image.
+ * @brief Creates the static layers of a game screen, then resets it.
+ *
+ * Must be called after init_game_screen(), the layers are released by
+ * free_game_screen_layers().
  *
- * @param[in,out] image Pointer to the image.
+ * @param[out] screen Pointer to the game screen.
+ */
+void init_game_screen_layers(GameScreen *screen);
+
+/**
+ * @brief Frees the static layers of a game screen.
+ *
+ * @param[in,out] screen Pointer to the game screen.
+ */
+void free_game_screen_layers(GameScreen *screen);
+
+/**
+ * @brief Forgets the previous frames: the next draw_game() repaints the whole window.
+ *
+ * @param[in,out] screen Pointer to the game screen.
+ */
+void reset_game_screen(GameScreen *screen);
+
+/**
+ * @brief Draws an image, or records it.
+ *
+ * @param[in,out] screen Game screen recording the draw, NULL to draw on the window.
+ * @param[in] image Image to draw.
  * @param[in] x X-coordinate of the top-left corner.
  * @param[in] y Y-coordinate of the top-left corner.
- * @param[in] width Width of the rectangle to clear.
- * @param[in] height Height of the rectangle to clear.
+ */
+void screen_draw_image(GameScreen *screen, const MLV_Image *image, int x, int y);
+
+/**
+ * @brief Draws a part of an image, or records it.
  *
- * @details
- * The specified rectangle is filled with transparent pixels.
+ * @param[in,out] screen Game screen recording the draw, NULL to draw on the window.
+ * @param[in] image Image to draw.
+ * @param[in] source_x X-coordinate of the part in the image.
+ * @param[in] source_y Y-coordinate of the part in the image.
+ * @param[in] width Width of the part.
+ * @param[in] height Height of the part.
+ * @param[in] x X-coordinate of the top-left corner on the window.
+ * @param[in] y Y-coordinate of the top-left corner on the window.
  */
-void delete_image_part(MLV_Image *image, int x, int y, int width, int height);
+void screen_draw_partial_image(GameScreen *screen, const MLV_Image *image,
+                               int source_x, int source_y, int width, int height,
+                               int x, int y);
 
 /**
- * @brief Rotates an image 90 degrees clockwise.
+ * @brief Draws a filled rectangle, or records it.
  *
- * @param[in,out] source Pointer to the image to rotate.
+ * @param[in,out] screen Game screen recording the draw, NULL to draw on the window.
+ * @param[in] x X-coordinate of the top-left corner.
+ * @param[in] y Y-coordinate of the top-left corner.
+ * @param[in] width Width of the rectangle.
+ * @param[in] height Height of the rectangle.
+ * @param[in] color Color of the rectangle.
  */
-void custom_rotate_right_image(MLV_Image *source);
+void screen_draw_filled_rectangle(GameScreen *screen, int x, int y, int width, int height, MLV_Color color);
 
 /**
  * @brief Draws a straight part of the snake's body.
@@ -47,12 +181,14 @@ void custom_rotate_right_image(MLV_Image *source);
  * @param[in] y Y-coordinate to draw the part.
  * @param[in] index Index of the body part in the snake.
  * @param[in] shift Fractional shift for smooth movement.
+ * @param[in,out] screen Game screen recording the draws, NULL to draw on the window.
  *
  * @details
- * Adjusts the image orientation based on movement direction, 
- * applies shift for animation, and draws it at the specified position.
+ * Picks the cached image of the movement direction and draws it at the
+ * specified position. The part next to the head (index 1) follows shift
+ * for the animation: only a sub-rectangle of the image is blitted.
  */
-void draw_straigth_body_part(SnakeSprite *sprite, vector2i delta_p, int x, int y, int index, float shift);
+void draw_straigth_body_part(SnakeSprite *sprite, vector2i delta_p, int x, int y, int index, float shift, GameScreen *screen);
 
 /**
  * @brief Draws a rotated (corner) part of the snake's body.
@@ -62,103 +198,126 @@ void draw_straigth_body_part(SnakeSprite *sprite, vector2i delta_p, int x, int y
  * @param[in] x X-coordinate to draw the part.
  * @param[in] y Y-coordinate to draw the part.
  * @param[in] up Flag indicating orientation (1 = normal, 0 = reversed).
+ * @param[in,out] screen Game screen recording the draws, NULL to draw on the window.
  *
  * @details
- * Adjusts the image by mirroring based on movement direction
+ * Picks the cached mirror of the image based on movement direction
  * and draws the rotated body part at the specified position.
  */
-void draw_rotated_body_part(SnakeSprite *sprite, vector2i delta_p, int x, int y, int up);
+void draw_rotated_body_part(SnakeSprite *sprite, vector2i delta_p, int x, int y, int up, GameScreen *screen);
 
 /**
  * @brief Draws the body segments of the snake (excluding head and tail).
  *
  * @param[in] snake Pointer to the Snake structure.
+ * @param[in] view Render data of the snake.
  * @param[in] shift Fraction of movement between cells (0.0 to 1.0).
+ * @param[in,out] screen Game screen recording the draws, NULL to draw on the window.
  */
-void draw_snake_body(Snake *snake, float shift);
+void draw_snake_body(Snake *snake, SnakeView *view, float shift, GameScreen *screen);
 
 /**
  * @brief Draws the snake's head with smooth movement based on shift.
  *
  * @param[in] snake Pointer to the Snake structure.
+ * @param[in] view Render data of the snake.
  * @param[in] shift Fraction of movement between cells (0.0 to 1.0).
+ * @param[in,out] screen Game screen recording the draws, NULL to draw on the window.
  */
-void draw_snake_head(Snake *snake, float shift);
+void draw_snake_head(Snake *snake, SnakeView *view, float shift, GameScreen *screen);
 
 /**
- * @brief Draws the current score on the screen.
+ * @brief Draws the current score on an image.
  *
  * @param[in] score The score to display.
+ * @param[in,out] image Image drawn on (the score panel layer).
  *
  * @details
  * Converts the score to a string and draws it at the top-left corner.
  */
-void draw_score(unsigned int score);
+void draw_score(unsigned int score, MLV_Image *image);
 
 /**
- * @brief Draws the high score list on the screen.
+ * @brief Draws the high score list on an image.
  *
  * @param[in] score_list Pointer to the array of scores.
+ * @param[in,out] image Image drawn on (the background layer).
  *
  * @details
  * Iterates through the score list, formats each score with its rank,
  * and draws them starting from a fixed position.
  */
-void draw_score_list(unsigned int *score_list);
+void draw_score_list(unsigned int *score_list, MLV_Image *image);
 
 /**
  * @brief Draws an apple on the screen.
  *
  * @param[in] config Pointer to the game configuration.
  * @param[in] object Pointer to the apple object.
+ * @param[in] view Render data of the apple.
+ * @param[in,out] screen Game screen recording the draws, NULL to draw on the window.
  *
  * @details
  * Draws either the apple sprite or a colored rectangle. 
  * Applies a small vertical oscillation if a sprite is used.
  */
-void draw_apple(GameConfig *config, GameObject *object);
+void draw_apple(GameConfig *config, GameObject *object, GameObjectView *view, GameScreen *screen);
 
 /**
  * @brief Draws a portal on the screen.
  *
  * @param[in] object Pointer to the portal object.
+ * @param[in] view Render data of the portal.
+ * @param[in,out] screen Game screen recording the draws, NULL to draw on the window.
  *
  * @details
  * Draws either the portal sprite or a colored rectangle at the object's position.
  */
-void draw_portal(GameObject *object);
+void draw_portal(GameObject *object, GameObjectView *view, GameScreen *screen);
 
 /**
  * @brief Draws all bottom-layer game objects.
  *
  * @param[in] config Pointer to the game configuration.
+ * @param[in] view Render data of the game.
+ * @param[in,out] screen Game screen recording the draws, NULL to draw on the window.
  *
  * @details
  * Iterates through all game objects and draws those that appear
  * on the bottom layer (e.g., apples).
  */
-void draw_bottoms_game_objects(GameConfig *config);
+void draw_bottoms_game_objects(GameConfig *config, GameView *view, GameScreen *screen);
 
 /**
  * @brief Draws all upper-layer game objects.
  *
  * @param[in] config Pointer to the game configuration.
+ * @param[in] view Render data of the game.
+ * @param[in,out] screen Game screen recording the draws, NULL to draw on the window.
  *
  * @details
  * Iterates through all game objects and draws those that appear
  * on the upper layer (e.g., portal).
  */
-void draw_uppers_game_objects(GameConfig *config) ;
+void draw_uppers_game_objects(GameConfig *config, GameView *view, GameScreen *screen);
 
 /**
  * @brief Draws the complete game screen (grid, apple, snakes).
  *
+ * Only the rectangles which changed since the previous frame are
+ * repainted (see the damage tracking above), then the window is updated.
+ *
  * @param[in] config Pointer to the GameConfig structure.
+ * @param[in] view Render data of the game.
+ * @param[in,out] screen Game screen: draw lists of the previous frames and damage.
+ * @param[in] score_list High score list drawn in single player mode.
  * @param[in] shift Fraction of movement between cells for smooth animation.
  */
-void draw_game(GameConfig *config, unsigned int *score_list, float shift);
+void draw_game(GameConfig *config, GameView *view, GameScreen *screen, unsigned int *score_list, float shift);
 
 /**
  * @brief Frees the game window and related resources.
  */
-void free_game_screen();
\ No newline at end of file
+void free_game_screen();
+
+#endif /* _GAME_SCREEN_H */
@@ -31,17 +31,67 @@ int deserialize_game_score(const char *file_name, unsigned int *score_list, int
     return res;
 }
 
-int serialize_game(const char *file_name, GameConfig *config) {
-    FILE *file;
+/*
+ * Checks that the fields of a snake read from a file fit in its buffer.
+ */
+static int is_valid_snake(Snake *snake) {
+    return snake->count >= 1 &&
+           snake->head_index < snake->capacity &&
+           snake->count + snake->back_buffer <= snake->capacity;
+}
+
+/*
+ * Writes a snake followed by its whole ring buffer.
+ */
+static void write_snake(FILE *file, Snake *snake) {
+    fwrite(snake, sizeof(Snake), 1, file);
+    fwrite(snake->items, sizeof(vector2i), snake->capacity, file);
+}
+
+/*
+ * Reads a snake written by write_snake() into a snake whose buffer is
+ * already allocated with the same capacity.
+ */
+static int read_snake(FILE *file, Snake *snake) {
+    Snake saved;
     int res;
 
+    res = fread(&saved, sizeof(Snake), 1, file) == 1 &&
+          saved.capacity == snake->capacity &&
+          fread(snake->items, sizeof(vector2i), snake->capacity, file) == snake->capacity;
+
+    if (res) {
+        saved.items = snake->items;
+        /* the queued turns are stamped with the clock of the saved game */
+        saved.turns_start = 0;
+        saved.turns_count = 0;
+        saved.turn_applied = 0;
+        *snake = saved;
+        res = is_valid_snake(snake);
+    }
+
+    return res;
+}
+
+int serialize_game(const char *file_name, GameConfig *config, GameView *view) {
+    FILE *file;
+    int res, i;
+
     file = fopen(file_name, "w");
 
     if (file == NULL) {
         res = 0;
     } else {
 
+        /* the pointers are saved too, but only the arena content matters */
         fwrite(config, sizeof(GameConfig), 1, file);
+
+        for (i = 0; i < config->snakes_count; i++)
+            write_snake(file, config->snakes + i);
+
+        for (i = 0; i < GAME_VIEW_PLAYERS_NUMBER; i++)
+            fwrite(&view->players[i].sprite_index, sizeof(int), 1, file);
+
         fclose(file);
         
         res = 1;
@@ -50,9 +100,10 @@ int serialize_game(const char *file_name, GameConfig *config) {
     return res;
 }
 
-int deserialize_game(const char *file_name, GameConfig *config) {
+int deserialize_game(const char *file_name, GameConfig *config, GameView *view) {
     FILE *file;
-    int res;
+    GameConfig loaded;
+    int res, i, sprite_index[GAME_VIEW_PLAYERS_NUMBER];
 
     file = fopen(file_name, "r");
 
@@ -61,32 +112,35 @@ int deserialize_game(const char *file_name, GameConfig *config) {
     } else {
 
         /* it isn't the final version of saving in file */
-        if (fread(config, sizeof(GameConfig), 1, file) == 1) {
-            res = 1;
-
-            config->first_player.sprite.head = NULL;
-            config->first_player.sprite.straight_body = NULL;
-            config->first_player.sprite.rotate_body = NULL;
-            config->first_player.sprite.tail = NULL;
-
-            load_snake_sprite(&config->first_player, config->first_player.sprite_index);
-            
-            if (config->game_mode == GAME_TWO_PLAYER_MODE) {
-                config->second_player.sprite.head = NULL;
-                config->second_player.sprite.straight_body = NULL;
-                config->second_player.sprite.rotate_body = NULL;
-                config->second_player.sprite.tail = NULL;
-
-                load_snake_sprite(&config->second_player, config->second_player.sprite_index);
-            }
-
-            load_objects_sprites(config);
-        } else {
-            res = 0;
+        res = fread(&loaded, sizeof(GameConfig), 1, file) == 1 &&
+              0 <= loaded.players_count && loaded.players_count <= loaded.snakes_count &&
+              alloc_game_arena(&loaded, loaded.grid.width, loaded.grid.height);
+
+        if (res) {
+            for (i = 0; i < loaded.snakes_count && res; i++)
+                res = read_snake(file, loaded.snakes + i);
+
+            res = res &&
+                  fread(sprite_index, sizeof(int), GAME_VIEW_PLAYERS_NUMBER, file) == GAME_VIEW_PLAYERS_NUMBER;
+
+            if (!res)
+                free_game(&loaded);
+        }
+
+        if (res) {
+            /* the running game (if any) is replaced */
+            free_game(config);
+            *config = loaded;
+
+            for (i = 0; i < config->players_count && i < GAME_VIEW_PLAYERS_NUMBER; i++)
+                load_snake_sprite(&view->players[i], sprite_index[i]);
+
+            load_objects_sprites(view, config);
+            rebuild_occupancy_grid(config);
         }
 
         fclose(file);
     }
     
     return res;
-}
\ No newline at end of file
+}
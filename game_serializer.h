@@ -10,6 +10,7 @@
 #include<stdio.h>
 
 #include"game_config.h"
+#include"game_view.h"
 
 /**
  * @brief Saves the score list to a binary file.
@@ -40,17 +41,25 @@ int deserialize_game_score(const char *file_name, unsigned int *score_list, int
 /**
  * @brief Saves the current game configuration to a file.
  *
+ * The skins of the players are saved after the game state.
+ *
  * @param[in] file_name Name/path of the file to save to.
  * @param[in] config Pointer to the GameConfig structure to serialize.
+ * @param[in] view Render data of the game.
  * @return int Returns 1 if successful, 0 if there was an error opening/writing the file.
  */
-int serialize_game(const char *file_name, GameConfig *config);
+int serialize_game(const char *file_name, GameConfig *config, GameView *view);
 
 /**
  * @brief Loads the game configuration from a file.
  *
+ * The player skins and object sprites of the view are reloaded. On success
+ * the previous game of config is released (its arena must be valid or NULL)
+ * and the loaded game must later be released with free_game().
+ *
  * @param[in] file_name Name/path of the file to read from.
- * @param[out] config Pointer to the GameConfig structure where the game state will be loaded.
+ * @param[in,out] config Pointer to the GameConfig structure where the game state will be loaded.
+ * @param[in,out] view Initialized render data, updated for the loaded game.
  * @return int Returns 1 if successful, 0 if there was an error opening/reading the file.
  */
-int deserialize_game(const char *file_name, GameConfig *config);
\ No newline at end of file
+int deserialize_game(const char *file_name, GameConfig *config, GameView *view);
\ No newline at end of file
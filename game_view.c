@@ -0,0 +1,476 @@
+#include"game_view.h"
+#include"skin_cache.h"
+#include"output_strategy.h"
+#include<SDL/SDL.h>
+
+static const AssetBundle *game_assets = NULL; /* NULL without bundle */
+static int game_assets_state = 0;             /* 0 not opened yet, 1 opened, -1 no bundle */
+
+#define SNAKE_PART_SIZE ( 32 )
+
+SnakeView create_snake_view() {
+    SnakeView rep;
+    int i;
+
+    for (i = 0; i < SPRITE_ORIENTATIONS_NUMBER; i++) {
+        rep.sprite.head[i] = NULL;
+        rep.sprite.straight_body[i] = NULL;
+        rep.sprite.tail[i] = NULL;
+    }
+    for (i = 0; i < SPRITE_MIRRORS_NUMBER; i++)
+        rep.sprite.rotate_body[i] = NULL;
+
+    rep.sprite_index = -1;
+    rep.color = MLV_COLOR_GREEN;
+
+    return rep;
+}
+
+void custom_rotate_right_image(MLV_Image *source) {
+    int height, width, i, j, r, g, b, a;
+    MLV_Image *tmp;
+
+    MLV_get_image_size(source, &width, &height);
+    tmp = MLV_copy_image(source);
+
+    for (i = 0; i < height; i++) {
+        for (j = 0; j < width; j++) {
+            MLV_get_pixel_on_image(tmp, j, i, &r, &g, &b, &a);
+            MLV_set_pixel_on_image(i, j, MLV_rgba(r, g, b, a), source);
+        }
+    }
+
+    MLV_free_image(tmp);
+}
+
+SPRITE_ORIENTATION get_sprite_orientation(SnakeDirection direction) {
+    SPRITE_ORIENTATION res;
+
+    switch (direction) {
+    case SNAKE_DIRECTION_LEFT:
+        res = SPRITE_ORIENTATION_LEFT;
+        break;
+    case SNAKE_DIRECTION_TOP:
+        res = SPRITE_ORIENTATION_TOP;
+        break;
+    case SNAKE_DIRECTION_BOTTOM:
+        res = SPRITE_ORIENTATION_BOTTOM;
+        break;
+    default:
+        res = SPRITE_ORIENTATION_RIGHT;
+        break;
+    }
+
+    return res;
+}
+
+/*
+ * Returns a new image: the image in the given orientation.
+ */
+static MLV_Image* create_oriented_image(MLV_Image *image, SPRITE_ORIENTATION orientation) {
+    MLV_Image *res;
+
+    res = MLV_copy_image(image);
+
+    switch (orientation) {
+    case SPRITE_ORIENTATION_LEFT:
+        MLV_vertical_image_mirror(res);
+        break;
+    case SPRITE_ORIENTATION_TOP:
+        custom_rotate_right_image(res);
+        MLV_horizontal_image_mirror(res);
+        break;
+    case SPRITE_ORIENTATION_BOTTOM:
+        custom_rotate_right_image(res);
+        break;
+    default:
+        break;
+    }
+
+    return res;
+}
+
+/*
+ * Returns a new image: the image with the given mirrors.
+ */
+static MLV_Image* create_mirrored_image(MLV_Image *image, SPRITE_MIRROR mirror) {
+    MLV_Image *res;
+
+    res = MLV_copy_image(image);
+
+    if (mirror == SPRITE_MIRROR_VERTICAL || mirror == SPRITE_MIRROR_BOTH)
+        MLV_vertical_image_mirror(res);
+    if (mirror == SPRITE_MIRROR_HORIZONTAL || mirror == SPRITE_MIRROR_BOTH)
+        MLV_horizontal_image_mirror(res);
+
+    return res;
+}
+
+/*
+ * Extracts one part of the sprite sheet at the size of a grid cell.
+ */
+static MLV_Image* load_snake_part(MLV_Image *image, int column, int row) {
+    MLV_Image *res;
+
+    res = MLV_copy_partial_image(image,
+                                 SNAKE_PART_SIZE * column, SNAKE_PART_SIZE * row,
+                                 SNAKE_PART_SIZE, SNAKE_PART_SIZE);
+    MLV_resize_image(res, GRID_CELL_DRAW_SIZE, GRID_CELL_DRAW_SIZE);
+
+    return res;
+}
+
+void get_snake_sprite_path(int index, char *path) {
+    strcpy(path, SNAKE_SPRITE_BASE_PATH);
+    path[SNAKE_SPRITE_NUMBER_INDEX] = '0' + index % 10;
+    path[SNAKE_SPRITE_NUMBER_INDEX - 1] = '0' + index / 10 % 10;
+    path[SNAKE_SPRITE_NUMBER_INDEX - 2] = '0' + index / 100 % 10;
+}
+
+void create_snake_sprite(SnakeSprite *sprite, MLV_Image *sheet) {
+    MLV_Image *head, *straight_body, *rotate_body, *tail;
+    int i;
+
+    head = load_snake_part(sheet, 2, 0);
+    straight_body = load_snake_part(sheet, 1, 0);
+    rotate_body = load_snake_part(sheet, 0, 0);
+    tail = load_snake_part(sheet, 0, 2);
+
+    for (i = 0; i < SPRITE_ORIENTATIONS_NUMBER; i++) {
+        sprite->head[i] = create_oriented_image(head, (SPRITE_ORIENTATION) i);
+        sprite->straight_body[i] = create_oriented_image(straight_body, (SPRITE_ORIENTATION) i);
+        sprite->tail[i] = create_oriented_image(tail, (SPRITE_ORIENTATION) i);
+    }
+    for (i = 0; i < SPRITE_MIRRORS_NUMBER; i++)
+        sprite->rotate_body[i] = create_mirrored_image(rotate_body, (SPRITE_MIRROR) i);
+
+    MLV_free_image(head);
+    MLV_free_image(straight_body);
+    MLV_free_image(rotate_body);
+    MLV_free_image(tail);
+}
+
+const AssetBundle* get_game_assets() {
+    static AssetBundle bundle;
+
+    if (game_assets_state == 0) {
+        game_assets_state = -1;
+
+        if (open_asset_bundle(&bundle, ASSET_BUNDLE_PATH)) {
+            if (bundle.header->cell_size == GRID_CELL_DRAW_SIZE) {
+                printf("Load assets from %s\n", ASSET_BUNDLE_PATH);
+                game_assets = &bundle;
+                game_assets_state = 1;
+            } else {
+                fprintf(stderr, "Warining : %s was baked for cells of %u pixels, not %d\n",
+                        ASSET_BUNDLE_PATH, (unsigned int) bundle.header->cell_size, GRID_CELL_DRAW_SIZE);
+                close_asset_bundle(&bundle);
+            }
+        }
+    }
+
+    return game_assets;
+}
+
+void free_game_assets() {
+    if (game_assets != NULL)
+        close_asset_bundle((AssetBundle*) game_assets);
+
+    game_assets = NULL;
+    game_assets_state = 0;
+}
+
+/*
+ * Copies 0xRRGGBBAA pixels in the surface of an image, row by row.
+ * Returns 0 if the surface can't be written directly (not 32 bits, or it
+ * must be locked).
+ */
+static int copy_pixels_to_surface(SDL_Surface *surface, const uint32_t *pixels, int width, int height) {
+    const SDL_PixelFormat *format;
+    uint32_t *line, color;
+    int x, y, res;
+
+    format = surface != NULL ? surface->format : NULL;
+    res = format != NULL && format->BytesPerPixel == 4 && !SDL_MUSTLOCK(surface);
+
+    for (y = 0; y < height && res; y++) {
+        line = (uint32_t*) ((unsigned char*) surface->pixels + y * surface->pitch);
+
+        /* same layout as the bundle: the row is copied as is */
+        if (format->Rmask == 0xFF000000u && format->Gmask == 0x00FF0000u &&
+            format->Bmask == 0x0000FF00u && format->Amask == 0x000000FFu) {
+            memcpy(line, pixels + y * width, width * sizeof(uint32_t));
+        } else {
+            for (x = 0; x < width; x++) {
+                color = pixels[y * width + x];
+                line[x] = (((color >> 24) << format->Rshift) & format->Rmask) |
+                          ((((color >> 16) & 0xFFu) << format->Gshift) & format->Gmask) |
+                          ((((color >> 8) & 0xFFu) << format->Bshift) & format->Bmask) |
+                          (((color & 0xFFu) << format->Ashift) & format->Amask);
+            }
+        }
+    }
+
+    return res;
+}
+
+MLV_Image* create_pixels_image(const uint32_t *pixels, int width, int height) {
+    MLV_Image *res;
+    uint32_t color;
+    int x, y;
+
+    res = MLV_create_image(width, height);
+
+    if (res != NULL && !copy_pixels_to_surface(MLV_get_image_data(res), pixels, width, height)) {
+        for (y = 0; y < height; y++) {
+            for (x = 0; x < width; x++) {
+                color = pixels[y * width + x];
+                MLV_set_pixel_on_image(x, y, MLV_rgba(color >> 24, (color >> 16) & 0xFF,
+                                                      (color >> 8) & 0xFF, color & 0xFF), res);
+            }
+        }
+    }
+
+    return res;
+}
+
+/*
+ * Returns a new image holding an image of the bundle, NULL if the bundle
+ * has no such image.
+ */
+static MLV_Image* create_asset_image(const AssetBundle *bundle, ASSET_KIND kind, int skin, int variant) {
+    MLV_Image *res;
+    const uint32_t *pixels;
+    int width, height;
+
+    res = NULL;
+    pixels = get_asset_pixels(bundle, get_asset_id(kind, skin, variant), &width, &height);
+
+    if (pixels != NULL)
+        res = create_pixels_image(pixels, width, height);
+
+    return res;
+}
+
+/*
+ * Fills a sprite with the images of a skin in the bundle. Returns 0 if
+ * one of them is missing.
+ */
+static int create_asset_snake_sprite(SnakeSprite *sprite, const AssetBundle *bundle, int index) {
+    int i, res;
+
+    res = 1;
+
+    for (i = 0; i < SPRITE_ORIENTATIONS_NUMBER; i++) {
+        sprite->head[i] = create_asset_image(bundle, ASSET_SNAKE_HEAD, index, i);
+        sprite->straight_body[i] = create_asset_image(bundle, ASSET_SNAKE_STRAIGHT_BODY, index, i);
+        sprite->tail[i] = create_asset_image(bundle, ASSET_SNAKE_TAIL, index, i);
+
+        res = res && sprite->head[i] != NULL && sprite->straight_body[i] != NULL && sprite->tail[i] != NULL;
+    }
+    for (i = 0; i < SPRITE_MIRRORS_NUMBER; i++) {
+        sprite->rotate_body[i] = create_asset_image(bundle, ASSET_SNAKE_ROTATE_BODY, index, i);
+        res = res && sprite->rotate_body[i] != NULL;
+    }
+
+    if (!res)
+        free_snake_sprite(sprite);
+
+    return res;
+}
+
+int load_snake_sprite_images(SnakeSprite *sprite, int index) {
+    const AssetBundle *bundle;
+    MLV_Image *sheet;
+    char path[SNAKE_SPRITE_PATH_SIZE];
+    int res;
+
+    bundle = get_game_assets();
+    res = bundle != NULL && create_asset_snake_sprite(sprite, bundle, index);
+
+    if (!res) {
+        get_snake_sprite_path(index, path);
+
+        printf("Load snake sprite %s\n", path);
+        sheet = MLV_load_image(path);
+        res = sheet != NULL;
+
+        if (res) {
+            create_snake_sprite(sprite, sheet);
+            MLV_free_image(sheet);
+        }
+    }
+
+    return res;
+}
+
+MLV_Image* load_snake_preview(int index, int size) {
+    const AssetBundle *bundle;
+    MLV_Image *res;
+    char path[SNAKE_SPRITE_PATH_SIZE];
+
+    bundle = get_game_assets();
+    res = NULL;
+
+    if (bundle != NULL && bundle->header->preview_size == (uint32_t) size)
+        res = create_asset_image(bundle, ASSET_SNAKE_PREVIEW, index, 0);
+
+    if (res == NULL) {
+        get_snake_sprite_path(index, path);
+
+        printf("Load snake preview %s\n", path);
+        res = MLV_load_image(path);
+
+        if (res != NULL)
+            MLV_resize_image_with_proportions(res, size, size);
+    }
+
+    return res;
+}
+
+void load_snake_sprite(SnakeView *view, int index) {
+    if (index < 0 || index > MAX_SNAKE_SPRITE_INDEX) {
+        fprintf(stderr, "Warining : snake sprite index %d out of bounds\nset sprite index to 0\n", index);
+        index = 0;
+    }
+
+    /* the new skin is borrowed before the old one is given back, so
+       reloading the same skin never decodes it again */
+    view->sprite = *acquire_skin_sprite(index);
+    if (view->sprite_index >= 0)
+        release_skin_sprite(view->sprite_index);
+
+    view->sprite_index = index;
+}
+
+void set_snake_color(SnakeView *view, MLV_Color color) {
+    if (color != MLV_COLOR_WHITE && color != MLV_COLOR_RED)
+        view->color = color;
+}
+
+/*
+ * Frees the non NULL images of an array and sets them to NULL. They are
+ * drawn through the output strategy, which forgets them.
+ */
+static void free_images(MLV_Image **images, int count) {
+    int i;
+
+    for (i = 0; i < count; i++) {
+        free_output_image(images[i]);
+        images[i] = NULL;
+    }
+}
+
+void free_snake_sprite(SnakeSprite *sprite) {
+    free_images(sprite->head, SPRITE_ORIENTATIONS_NUMBER);
+    free_images(sprite->straight_body, SPRITE_ORIENTATIONS_NUMBER);
+    free_images(sprite->tail, SPRITE_ORIENTATIONS_NUMBER);
+    free_images(sprite->rotate_body, SPRITE_MIRRORS_NUMBER);
+}
+
+void free_snake_view(SnakeView *view) {
+    int i;
+
+    if (view->sprite_index >= 0)
+        release_skin_sprite(view->sprite_index);
+
+    /* the images belong to the skin cache */
+    for (i = 0; i < SPRITE_ORIENTATIONS_NUMBER; i++) {
+        view->sprite.head[i] = NULL;
+        view->sprite.straight_body[i] = NULL;
+        view->sprite.tail[i] = NULL;
+    }
+    for (i = 0; i < SPRITE_MIRRORS_NUMBER; i++)
+        view->sprite.rotate_body[i] = NULL;
+
+    view->sprite_index = -1;
+}
+
+void init_game_view(GameView *view) {
+    int i;
+
+    for (i = 0; i < GAME_VIEW_PLAYERS_NUMBER; i++)
+        view->players[i] = create_snake_view();
+
+    set_snake_color(&view->players[1], MLV_COLOR_BLUE);
+
+    for (i = 0; i < GAME_OBJECTS_NUMBER; i++) {
+        view->objects[i].sprite = NULL;
+        view->objects[i].color = MLV_rgba(0, 0, 0, 255);
+    }
+}
+
+void load_game_view(GameView *view, GameConfig *config) {
+    int i;
+
+    for (i = 0; i < config->players_count && i < GAME_VIEW_PLAYERS_NUMBER; i++) {
+        if (view->players[i].sprite_index < 0)
+            load_snake_sprite(&view->players[i], DEFAULT_SNAKE_SPRITE_INDEX);
+    }
+
+    load_objects_sprites(view, config);
+}
+
+MLV_Image* save_sprite_load(const char *file_name) {
+    FILE *file;
+    MLV_Image *res;
+
+    file = fopen(file_name, "r");
+    if (file == NULL) {
+        res = NULL;
+    } else {
+        fclose(file);
+
+        res = MLV_load_image(file_name);
+        MLV_resize_image(res, GRID_CELL_DRAW_SIZE, GRID_CELL_DRAW_SIZE);
+    }
+
+    return res;
+}
+
+void load_objects_sprites(GameView *view, GameConfig *config) {
+    int i;
+    GameObjectView *object;
+
+    free_game_objects(view);
+
+    for (i = 0; i < GAME_OBJECTS_NUMBER; i++) {
+        object = &view->objects[i];
+
+        switch (config->objects[i].type) {
+        case GAME_OBJECT_APPLE:
+            object->sprite = get_game_assets() == NULL ? NULL :
+                             create_asset_image(get_game_assets(), ASSET_APPLE, 0, 0);
+            if (object->sprite == NULL)
+                object->sprite = save_sprite_load(APPLE_SPRITE_PATH);
+            object->color = MLV_rgba(255, 0, 0, 255);
+            break;
+        case GAME_OBJECT_PORTAL:
+            object->sprite = NULL;
+            object->color = MLV_rgba(0, 0, 255, 255);
+            break;
+        default:
+            object->sprite = NULL;
+            object->color = MLV_rgba(0, 0, 0, 255);
+            break;
+        }
+    }
+}
+
+void free_game_objects(GameView *view) {
+    int i;
+
+    for (i = 0; i < GAME_OBJECTS_NUMBER; i++) {
+        free_output_image(view->objects[i].sprite);
+        view->objects[i].sprite = NULL;
+    }
+}
+
+void free_game_view(GameView *view) {
+    int i;
+
+    for (i = 0; i < GAME_VIEW_PLAYERS_NUMBER; i++)
+        free_snake_view(&view->players[i]);
+
+    free_game_objects(view);
+}
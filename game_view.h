@@ -0,0 +1,303 @@
+/**
+ * @file game_view.h
+ * @brief Render data of the Snake game, kept beside the simulation state.
+ *
+ * The simulation structures (Snake, GameObject, GameConfig) are plain data
+ * and do not know about MLV. This file defines the parallel structures
+ * holding everything needed to draw them: sprites and colors.
+ *
+ * `GameView.players[0]` and `GameView.players[1]` describe the first and
+ * second player snakes, `GameView.objects[i]` describes `GameConfig.objects[i]`.
+ */
+
+#ifndef _GAME_VIEW_H
+#define _GAME_VIEW_H
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<string.h>
+#include<MLV/MLV_all.h>
+
+#include"game_setup.h"
+#include"game_config.h"
+#include"asset_bundle.h"
+
+#define MAX_SNAKE_SPRITE_INDEX 21                              /**< Last available snake skin */
+#define DEFAULT_SNAKE_SPRITE_INDEX 15                          /**< Skin used when none was selected */
+#define SNAKE_SPRITE_BASE_PATH "ressources/snake/snake000.png" /**< Path pattern of the skin files */
+#define SNAKE_SPRITE_NUMBER_INDEX 24                           /**< Position of the last digit in the path */
+#define SNAKE_SPRITE_PATH_SIZE 35                              /**< Size of a buffer holding the path of a skin file */
+#define APPLE_SPRITE_PATH "ressources/apple.png"               /**< Path of the apple image */
+
+#define GAME_VIEW_PLAYERS_NUMBER 2 /**< Number of player snakes drawn by a GameView */
+
+/**
+ * @enum SPRITE_ORIENTATION
+ * @brief Orientations of the head, tail and straight body images.
+ */
+typedef enum {
+    SPRITE_ORIENTATION_RIGHT = 0, /**< Image as in the sprite sheet. */
+    SPRITE_ORIENTATION_LEFT,      /**< Vertical mirror. */
+    SPRITE_ORIENTATION_TOP,       /**< Rotated, then horizontal mirror. */
+    SPRITE_ORIENTATION_BOTTOM,    /**< Rotated. */
+    SPRITE_ORIENTATIONS_NUMBER    /**< Number of orientations. */
+} SPRITE_ORIENTATION;
+
+/**
+ * @enum SPRITE_MIRROR
+ * @brief Mirrors of the curved body image.
+ */
+typedef enum {
+    SPRITE_MIRROR_NONE = 0,       /**< Image as in the sprite sheet. */
+    SPRITE_MIRROR_VERTICAL,       /**< Vertical mirror. */
+    SPRITE_MIRROR_HORIZONTAL,     /**< Horizontal mirror. */
+    SPRITE_MIRROR_BOTH,           /**< Vertical and horizontal mirrors. */
+    SPRITE_MIRRORS_NUMBER         /**< Number of mirrors. */
+} SPRITE_MIRROR;
+
+/**
+ * @struct SnakeSprite
+ * @brief Holds all sprite images used for rendering the snake.
+ *
+ * This structure groups together the different image assets required
+ * to draw the snake, including the head, tail, straight body segments,
+ * and curved body segments used during turns.
+ *
+ * Every orientation (or mirror) of every part is computed once by
+ * create_snake_sprite(), so drawing a snake only blits cached images and
+ * allocates nothing.
+ */
+typedef struct {
+    MLV_Image *head[SPRITE_ORIENTATIONS_NUMBER];          /**< Images of the snake's head. */
+    MLV_Image *tail[SPRITE_ORIENTATIONS_NUMBER];          /**< Images of the snake's tail. */
+    MLV_Image *straight_body[SPRITE_ORIENTATIONS_NUMBER]; /**< Images used for straight body segments. */
+    MLV_Image *rotate_body[SPRITE_MIRRORS_NUMBER];        /**< Images used for curved/turn body segments. */
+} SnakeSprite;
+
+/**
+ * @struct SnakeView
+ * @brief Render data of one snake.
+ */
+typedef struct {
+    SnakeSprite sprite;  /**< Sprite images borrowed from the skin cache, NULL when not loaded. */
+    int sprite_index;    /**< Index of the loaded skin, -1 when not loaded. */
+    MLV_Color color;     /**< Color used to render the snake. */
+} SnakeView;
+
+/**
+ * @struct GameObjectView
+ * @brief Render data of one game object.
+ */
+typedef struct {
+    MLV_Image *sprite;   /**< Sprite image for rendering, NULL to draw a colored cell. */
+    MLV_Color color;     /**< Object color. */
+} GameObjectView;
+
+/**
+ * @struct GameView
+ * @brief Render data of a whole game, parallel to GameConfig.
+ */
+typedef struct {
+    SnakeView players[GAME_VIEW_PLAYERS_NUMBER]; /**< Player snakes render data */
+    GameObjectView objects[GAME_OBJECTS_NUMBER]; /**< Game objects render data */
+} GameView;
+
+/**
+ * @brief Creates the render data of a snake, without any sprite loaded.
+ *
+ * @return SnakeView Green snake view with no skin.
+ */
+SnakeView create_snake_view();
+
+/**
+ * @brief Writes the path of the sprite sheet of a skin.
+ *
+ * @param[in] index Index of the skin (0 to 999).
+ * @param[out] path Buffer of SNAKE_SPRITE_PATH_SIZE characters.
+ */
+void get_snake_sprite_path(int index, char *path);
+
+/**
+ * @brief Creates all snake sprite sub-images from a sprite sheet.
+ *
+ * Extracts the individual images (head, straight body, rotated body, tail)
+ * at the size of a grid cell and computes all their orientations and
+ * mirrors. Calls MLV, so it runs on the main thread only.
+ *
+ * @param[out] sprite Pointer to the sprite, released with free_snake_sprite().
+ * @param[in]  sheet  Sprite sheet of a skin, left unchanged.
+ */
+void create_snake_sprite(SnakeSprite *sprite, MLV_Image *sheet);
+
+/**
+ * @brief Frees the images of a sprite and sets them to NULL.
+ *
+ * The current output strategy forgets them (free_output_image()).
+ *
+ * @param[in,out] sprite Pointer to the sprite.
+ */
+void free_snake_sprite(SnakeSprite *sprite);
+
+/**
+ * @brief Returns the asset bundle of the game, opened at the first call.
+ *
+ * The first call must come from the main thread: the bundle
+ * ASSET_BUNDLE_PATH is mapped if it exists and was baked for
+ * GRID_CELL_DRAW_SIZE. Later calls only read it.
+ *
+ * @return const AssetBundle* The bundle, NULL if the images must be
+ *         loaded from their PNG files.
+ */
+const AssetBundle* get_game_assets();
+
+/**
+ * @brief Unmaps the asset bundle.
+ *
+ * No image may be loaded from it any more; the next get_game_assets()
+ * opens it again.
+ */
+void free_game_assets();
+
+/**
+ * @brief Creates an image from its pixels.
+ *
+ * The rows are written straight into the SDL surface of the image (a
+ * copy when it has the same layout), or pixel by pixel through MLV when
+ * the surface is not 32 bits or must be locked.
+ *
+ * @param[in] pixels width * height colors, row by row, 0xRRGGBBAA (as MLV_Color).
+ * @param[in] width Width in pixels.
+ * @param[in] height Height in pixels.
+ * @return MLV_Image* The new image, NULL if it can't be created.
+ */
+MLV_Image* create_pixels_image(const uint32_t *pixels, int width, int height);
+
+/**
+ * @brief Creates the game images of a skin.
+ *
+ * They are copied from the asset bundle if there is one, otherwise the
+ * sprite sheet is decoded and cut by create_snake_sprite().
+ *
+ * @param[out] sprite Pointer to the sprite, released with free_snake_sprite().
+ * @param[in]  index  Index of the skin.
+ * @return int 1 on success, 0 if the sprite sheet cannot be loaded.
+ */
+int load_snake_sprite_images(SnakeSprite *sprite, int index);
+
+/**
+ * @brief Creates the preview of a skin: its sprite sheet resized.
+ *
+ * It is copied from the asset bundle if there is one with previews of
+ * this size, otherwise the sprite sheet is decoded and resized.
+ *
+ * @param[in] index Index of the skin.
+ * @param[in] size  Side of the preview in pixels.
+ * @return MLV_Image* The new preview, NULL if the sprite sheet cannot be loaded.
+ */
+MLV_Image* load_snake_preview(int index, int size);
+
+/**
+ * @brief Gives a snake the images of a skin.
+ *
+ * The images are borrowed from the skin cache (skin_cache.h): a skin is
+ * only decoded the first time it is used. The skin previously used by
+ * the view is given back to the cache.
+ *
+ * @param[in,out] view  Pointer to the SnakeView to modify.
+ * @param[in]     index Index of the skin.
+ */
+void load_snake_sprite(SnakeView *view, int index);
+
+/**
+ * @brief Rotates an image 90 degrees clockwise.
+ *
+ * Works pixel by pixel: only meant for loading, not for drawing.
+ *
+ * @param[in,out] source Pointer to the image to rotate.
+ */
+void custom_rotate_right_image(MLV_Image *source);
+
+/**
+ * @brief Returns the sprite orientation of a snake moving in a direction.
+ *
+ * @param[in] direction Direction of the snake part.
+ * @return SPRITE_ORIENTATION Orientation of its image.
+ */
+SPRITE_ORIENTATION get_sprite_orientation(SnakeDirection direction);
+
+/**
+ * @brief Changes the rendering color of the snake.
+ *
+ * White and red are disallowed as playable colors for visibility reasons.
+ *
+ * @param[out] view Pointer.
+ * @param[in] color New color to apply.
+ */
+void set_snake_color(SnakeView *view, MLV_Color color);
+
+/**
+ * @brief Gives the skin of a snake view back to the skin cache.
+ *
+ * @param[in,out] view Pointer.
+ */
+void free_snake_view(SnakeView *view);
+
+/**
+ * @brief Initializes a game view with no image loaded.
+ *
+ * The first player is green and the second one blue.
+ *
+ * @param[out] view Pointer to the view to initialize.
+ */
+void init_game_view(GameView *view);
+
+/**
+ * @brief Loads every image still missing for a game.
+ *
+ * Players without skin get DEFAULT_SNAKE_SPRITE_INDEX, and the game
+ * objects sprites are (re)loaded.
+ *
+ * @param[in,out] view Pointer to the game view.
+ * @param[in] config Game drawn with this view.
+ */
+void load_game_view(GameView *view, GameConfig *config);
+
+/**
+ * @brief Loads an image resized to a grid cell.
+ *
+ * @param[in] file_name Path of the image.
+ * @return MLV_Image* The new image, NULL if the file does not exist.
+ */
+MLV_Image* save_sprite_load(const char *file_name);
+
+/**
+ * @brief Loads sprites and colors for all game objects.
+ *
+ * Assigns the correct sprite and display color depending on object type.
+ * Previously loaded object sprites are freed.
+ *
+ * @param[in,out] view Pointer to the game view.
+ * @param[in] config Game whose objects are loaded.
+ */
+void load_objects_sprites(GameView *view, GameConfig *config);
+
+/**
+ * @brief Frees all loaded sprites of game objects.
+ *
+ * Releases memory allocated for object images, forgotten by the current
+ * output strategy (free_output_image()).
+ *
+ * @param[in,out] view Pointer to the game view.
+ */
+void free_game_objects(GameView *view);
+
+/**
+ * @brief Frees all resources used by the game view.
+ *
+ * Releases snakes and game object images.
+ *
+ * @param[in,out] view Pointer to the game view.
+ */
+void free_game_view(GameView *view);
+
+#endif /* _GAME_VIEW_H */
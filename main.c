@@ -18,17 +18,28 @@
 
 #include<stdlib.h>
 #include<stdio.h>
-#include<time.h>
+#include<string.h>
 
 #include"game_menu.h"
 
 
 
-int main() {
-    
-    srand(time(NULL));
+int main(int argc, char **argv) {
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0)
+            enable_frame_profiler(1);
+        else if (strcmp(argv[i], "--perf-counters") == 0)
+            open_perf_counters();
+        else
+            fprintf(stderr, "Warining : unknown option %s\n", argv[i]);
+    }
 
     show_menu_screen();
+
+    save_frame_profiler_csv(FRAME_PROFILER_CSV_PATH);
+    close_perf_counters();
     
     exit(EXIT_SUCCESS);
 }
\ No newline at end of file
@@ -10,7 +10,7 @@ MLV_Button MLV_create_button_with_font(const char *text, const char *font, int f
     res.pos = pos;
     res.size = size;
 
-    res.font = MLV_load_font(font, font_size);
+    res.font = acquire_font(font, font_size);
     
     res.fill_color = fill_color;
     res.text_color = text_color;
@@ -47,6 +47,7 @@ int MLV_mouse_is_on_button(MLV_Button *button, vector2i *mouse_p) {
 
 void MLV_draw_button(MLV_Button *button, vector2i *mouse_p) {
     MLV_Color fill_color;
+    MLV_Image *image;
 
     if (MLV_mouse_is_on_button(button, mouse_p)) {
         fill_color = button->highlight_color;
@@ -54,13 +55,21 @@ void MLV_draw_button(MLV_Button *button, vector2i *mouse_p) {
         fill_color = button->fill_color;
     }
 
-    MLV_draw_text_box_with_font(button->pos.x, button->pos.y,
-                      button->size.x, button->size.y,
-                                button->text, button->font, 1,
-                      MLV_COLOR_BLACK, button->text_color, fill_color,
-                      MLV_TEXT_CENTER, MLV_HORIZONTAL_CENTER, MLV_VERTICAL_CENTER);
+    /* laid out once per state of the button, then drawn from the text cache */
+    image = get_text_box_image(button->text, button->font,
+                               button->size.x, button->size.y, 1,
+                               MLV_COLOR_BLACK, button->text_color, fill_color);
+
+    if (image != NULL)
+        MLV_draw_image(image, button->pos.x, button->pos.y);
+    else
+        MLV_draw_text_box_with_font(button->pos.x, button->pos.y,
+                          button->size.x, button->size.y,
+                                    button->text, button->font, 1,
+                          MLV_COLOR_BLACK, button->text_color, fill_color,
+                          MLV_TEXT_CENTER, MLV_HORIZONTAL_CENTER, MLV_VERTICAL_CENTER);
 }
 
 void MLV_free_button(MLV_Button *button) {
-    MLV_free_font(button->font);
+    release_font(button->font);
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include<MLV/MLV_all.h>
 #include<string.h>
 #include"vector2i.h"
+#include"text_cache.h"
+#include"font_registry.h"
 
 /**
  * @brief Represents a clickable button in the UI.
@@ -29,7 +31,7 @@ typedef struct {
  * @brief Creates a button with a specified font.
  *
  * @param[in] text Text to display on the button.
- * @param[in] font Path to the font file.
+ * @param[in] font Path to the font file, loaded once by the font registry.
  * @param[in] font_size Size of the font.
  * @param[in] pos Top-left position of the button.
  * @param[in] size Width and height of the button.
@@ -40,6 +42,7 @@ typedef struct {
  *
  * @details
  * Initializes a button with the given text, font, colors, and position/size.
+ * The font is borrowed from the font registry until MLV_free_button().
  */
 MLV_Button MLV_create_button_with_font(const char *text, const char *font, int font_size,
                                        vector2i position, vector2i size,
@@ -0,0 +1,240 @@
+#include"noise_field.h"
+
+#include<stdlib.h>
+#include<string.h>
+
+#if NOISE_FIELD_SIMD
+#include<emmintrin.h>
+#endif
+
+#define NOISE_ROW_STEP 57.0f   /**< Hash input step between two lattice rows */
+#define NOISE_TIME_STEP 13.0f  /**< Hash input step per time unit */
+
+int init_noise_field(NoiseField *field, int width, int height, int tile) {
+    field->width = width;
+    field->height = height;
+    field->tile = tile;
+    field->columns = (width + tile - 1) / tile;
+    field->rows = (height + tile - 1) / tile;
+
+    field->colors = (uint32_t*) malloc(field->columns * field->rows * sizeof(uint32_t));
+
+    return field->colors != NULL;
+}
+
+void free_noise_field(NoiseField *field) {
+    free(field->colors);
+    field->colors = NULL;
+}
+
+/*
+ * Fractional part of a positive value.
+ */
+static float fract_noise(float p) {
+    return p - (float) (int) p;
+}
+
+/*
+ * Pseudo-random value in [0, 1) of a positive input, float operations only.
+ */
+static float hash_noise(float p) {
+    p = fract_noise(p * 0.1031f);
+    p *= p + 33.33f;
+    p *= p + p;
+
+    return fract_noise(p);
+}
+
+/*
+ * Packs the channels of a tile, scaled by its shade.
+ */
+static uint32_t shade_noise_color(const NoiseShade *shade, float value) {
+    uint32_t r, g, b;
+
+    r = (uint32_t) (int) (shade->r * value);
+    g = (uint32_t) (int) (shade->g * value);
+    b = (uint32_t) (int) (shade->b * value);
+
+    return (r << 24) | (g << 16) | (b << 8) | 255u;
+}
+
+/*
+ * Computes the tiles [begin, columns) of a row.
+ * v is the position of the row in its lattice cell, base and next the
+ * hash inputs of the lattice rows above and below it.
+ */
+static void compute_noise_tiles(NoiseField *field, uint32_t *colors, int begin,
+                                float v, float base, float next,
+                                const NoiseShade *shade) {
+    float x, fx, u, a, b, c, d, lerp1, lerp2, n;
+    int i;
+
+    for (i = begin; i < field->columns; i++) {
+        x = (float) (i * field->tile) * NOISE_FIELD_SCALE;
+        fx = (float) (int) x;
+        u = x - fx;
+
+        a = hash_noise(fx + base);
+        b = hash_noise(fx + 1.0f + base);
+        c = hash_noise(fx + next);
+        d = hash_noise(fx + 1.0f + next);
+
+        lerp1 = a + u * (b - a);
+        lerp2 = c + u * (d - c);
+        n = lerp1 + v * (lerp2 - lerp1);
+
+        colors[i] = shade_noise_color(shade, shade->min_shade + n * (shade->max_shade - shade->min_shade));
+    }
+}
+
+void compute_noise_rows_scalar(NoiseField *field, int begin, int end, const NoiseShade *shade, float time_s) {
+    float y, fy, t;
+    int j;
+
+    t = time_s * NOISE_FIELD_SPEED * NOISE_TIME_STEP;
+
+    for (j = begin; j < end && j < field->rows; j++) {
+        y = (float) (j * field->tile) * NOISE_FIELD_SCALE;
+        fy = (float) (int) y;
+
+        compute_noise_tiles(field, field->colors + j * field->columns, 0, y - fy,
+                            fy * NOISE_ROW_STEP + t, (fy + 1.0f) * NOISE_ROW_STEP + t, shade);
+    }
+}
+
+#if NOISE_FIELD_SIMD
+
+static __m128 fract_noise4(__m128 p) {
+    return _mm_sub_ps(p, _mm_cvtepi32_ps(_mm_cvttps_epi32(p)));
+}
+
+static __m128 hash_noise4(__m128 p) {
+    p = fract_noise4(_mm_mul_ps(p, _mm_set1_ps(0.1031f)));
+    p = _mm_mul_ps(p, _mm_add_ps(p, _mm_set1_ps(33.33f)));
+    p = _mm_mul_ps(p, _mm_add_ps(p, p));
+
+    return fract_noise4(p);
+}
+
+static __m128i shade_noise_color4(__m128 channel, __m128 value, int shift) {
+    return _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(channel, value)), shift);
+}
+
+void compute_noise_rows(NoiseField *field, int begin, int end, const NoiseShade *shade, float time_s) {
+    __m128 x, fx, u, v, a, b, c, d, lerp1, lerp2, n, value, base, next, one;
+    __m128 scale, min_shade, range, r, g, bl;
+    __m128i columns, step, pixel;
+    float y, fy, t;
+    uint32_t *colors;
+    int i, j;
+
+    t = time_s * NOISE_FIELD_SPEED * NOISE_TIME_STEP;
+
+    one = _mm_set1_ps(1.0f);
+    scale = _mm_set1_ps(NOISE_FIELD_SCALE);
+    min_shade = _mm_set1_ps(shade->min_shade);
+    range = _mm_set1_ps(shade->max_shade - shade->min_shade);
+    r = _mm_set1_ps(shade->r);
+    g = _mm_set1_ps(shade->g);
+    bl = _mm_set1_ps(shade->b);
+    step = _mm_set1_epi32(4 * field->tile);
+
+    for (j = begin; j < end && j < field->rows; j++) {
+        y = (float) (j * field->tile) * NOISE_FIELD_SCALE;
+        fy = (float) (int) y;
+
+        v = _mm_set1_ps(y - fy);
+        base = _mm_set1_ps(fy * NOISE_ROW_STEP + t);
+        next = _mm_set1_ps((fy + 1.0f) * NOISE_ROW_STEP + t);
+
+        colors = field->colors + j * field->columns;
+        columns = _mm_setr_epi32(0, field->tile, 2 * field->tile, 3 * field->tile);
+
+        for (i = 0; i + 4 <= field->columns; i += 4) {
+            x = _mm_mul_ps(_mm_cvtepi32_ps(columns), scale);
+            fx = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+            u = _mm_sub_ps(x, fx);
+
+            a = hash_noise4(_mm_add_ps(fx, base));
+            b = hash_noise4(_mm_add_ps(_mm_add_ps(fx, one), base));
+            c = hash_noise4(_mm_add_ps(fx, next));
+            d = hash_noise4(_mm_add_ps(_mm_add_ps(fx, one), next));
+
+            lerp1 = _mm_add_ps(a, _mm_mul_ps(u, _mm_sub_ps(b, a)));
+            lerp2 = _mm_add_ps(c, _mm_mul_ps(u, _mm_sub_ps(d, c)));
+            n = _mm_add_ps(lerp1, _mm_mul_ps(v, _mm_sub_ps(lerp2, lerp1)));
+
+            value = _mm_add_ps(min_shade, _mm_mul_ps(n, range));
+
+            pixel = _mm_or_si128(shade_noise_color4(r, value, 24), shade_noise_color4(g, value, 16));
+            pixel = _mm_or_si128(pixel, shade_noise_color4(bl, value, 8));
+            pixel = _mm_or_si128(pixel, _mm_set1_epi32(255));
+
+            _mm_storeu_si128((__m128i*) (colors + i), pixel);
+
+            columns = _mm_add_epi32(columns, step);
+        }
+
+        /* last tiles of a row whose width is not a multiple of 4 */
+        compute_noise_tiles(field, colors, i, y - fy,
+                            fy * NOISE_ROW_STEP + t, (fy + 1.0f) * NOISE_ROW_STEP + t, shade);
+    }
+}
+
+#else
+
+void compute_noise_rows(NoiseField *field, int begin, int end, const NoiseShade *shade, float time_s) {
+    compute_noise_rows_scalar(field, begin, end, shade, time_s);
+}
+
+#endif
+
+void compute_noise_frame(NoiseField *field, const NoiseFrame *frame, int begin, int end) {
+    if (begin < frame->split_row)
+        compute_noise_rows(field, begin, end < frame->split_row ? end : frame->split_row,
+                           &frame->top, frame->time_s);
+
+    if (end > frame->split_row)
+        compute_noise_rows(field, begin > frame->split_row ? begin : frame->split_row, end,
+                           &frame->bottom, frame->time_s);
+}
+
+/*
+ * Converts a packed color (0xRRGGBBAA) to a pixel of the target.
+ */
+static uint32_t get_noise_pixel(const NoiseTarget *target, uint32_t color) {
+    uint32_t res;
+    int i;
+
+    res = 0;
+
+    for (i = 0; i < 4; i++)
+        res |= (((color >> (24 - 8 * i)) & 0xFFu) << target->shifts[i]) & target->masks[i];
+
+    return res;
+}
+
+void paint_noise_rows(const NoiseField *field, const NoiseTarget *target, int begin, int end) {
+    const uint32_t *colors;
+    uint32_t *line, pixel;
+    int i, j, x, y, top, bottom, right;
+
+    for (j = begin; j < end && j < field->rows; j++) {
+        colors = field->colors + j * field->columns;
+        top = j * field->tile;
+        bottom = top + field->tile < field->height ? top + field->tile : field->height;
+
+        /* the first line of the row, copied to the other lines */
+        line = target->pixels + top * target->pitch;
+        for (i = 0; i < field->columns; i++) {
+            pixel = get_noise_pixel(target, colors[i]);
+            right = (i + 1) * field->tile < field->width ? (i + 1) * field->tile : field->width;
+
+            for (x = i * field->tile; x < right; x++)
+                line[x] = pixel;
+        }
+
+        for (y = top + 1; y < bottom; y++)
+            memcpy(target->pixels + y * target->pitch, line, field->width * sizeof(uint32_t));
+    }
+}
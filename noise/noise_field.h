@@ -0,0 +1,154 @@
+/**
+ * @file noise_field.h
+ * @brief Animated value noise of the menu background, one color per tile.
+ *
+ * The window is split in square tiles and every tile gets one color, so
+ * the field is a contiguous buffer of `columns * rows` packed colors
+ * (0xRRGGBBAA, the layout of MLV_Color) which is uploaded in one go.
+ *
+ * The lattice values come from a float-only hash (no sin nor fmod, all
+ * the inputs are positive so the floor is a truncation). On SSE2 the
+ * tiles of a row are computed 4 at a time; every operation is the same
+ * single precision operation as in the scalar code, in the same order,
+ * so both paths give bit-identical colors.
+ *
+ * paint_noise_rows() fills the pixels of the tiles of some rows in a
+ * 32 bits image (NoiseTarget), so the upload of a frame can be done by
+ * the thread which computed it.
+ */
+
+#ifndef _NOISE_FIELD_H
+#define _NOISE_FIELD_H
+
+#include<stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define NOISE_FIELD_SIMD 1  /**< 1 if compute_noise_rows() uses SSE2 */
+#else
+#define NOISE_FIELD_SIMD 0
+#endif
+
+#define NOISE_FIELD_SCALE 0.1f  /**< Lattice cells per pixel */
+#define NOISE_FIELD_SPEED 0.15f /**< Time scale of the animation */
+
+/**
+ * @struct NoiseShade
+ * @brief Color of a band of rows: the channels are scaled by a noise
+ * driven value between min_shade and max_shade.
+ */
+typedef struct {
+    float r, g, b;     /**< Channels of the palette, between 0 and 1 */
+    float min_shade;   /**< Shade of a noise value of 0 (0 to 255) */
+    float max_shade;   /**< Shade of a noise value of 1 (0 to 255) */
+} NoiseShade;
+
+/**
+ * @struct NoiseFrame
+ * @brief Parameters of one frame of the background: the rows above
+ * split_row (the title band) and the other rows have their own shade.
+ */
+typedef struct {
+    NoiseShade top;    /**< Shade of the rows above split_row */
+    NoiseShade bottom; /**< Shade of the other rows */
+    int split_row;     /**< First row of the bottom shade */
+    float time_s;      /**< Animation time in seconds (positive) */
+} NoiseFrame;
+
+/**
+ * @struct NoiseField
+ * @brief Colors of the tiles, row by row.
+ */
+typedef struct {
+    int width;         /**< Width of the area in pixels */
+    int height;        /**< Height of the area in pixels */
+    int columns;       /**< Tiles in one row */
+    int rows;          /**< Rows of tiles */
+    int tile;          /**< Width and height of a tile in pixels */
+    uint32_t *colors;  /**< columns * rows packed colors */
+} NoiseField;
+
+/**
+ * @struct NoiseTarget
+ * @brief 32 bits pixels of an image the tiles of a field are painted in.
+ *
+ * The channels of a pixel are placed with the masks and shifts of the
+ * image format (red, green, blue, alpha), a channel with a mask of 0 is
+ * left out.
+ */
+typedef struct {
+    uint32_t *pixels;  /**< First pixel of the image, NULL if none */
+    int pitch;         /**< Pixels from one line of the image to the next */
+    int shifts[4];     /**< Lowest bit of each channel in a pixel */
+    uint32_t masks[4]; /**< Bits of each channel in a pixel */
+} NoiseTarget;
+
+/**
+ * @brief Allocates the field covering a width x height pixels area.
+ *
+ * Must be released with free_noise_field().
+ *
+ * @param[out] field Pointer to the field.
+ * @param[in] width Width of the area in pixels.
+ * @param[in] height Height of the area in pixels.
+ * @param[in] tile Side of a tile in pixels (greater than 0).
+ * @return int 1 on success, 0 if the allocation failed.
+ */
+int init_noise_field(NoiseField *field, int width, int height, int tile);
+
+/**
+ * @brief Releases the colors of the field.
+ *
+ * @param[in,out] field Pointer to the field.
+ */
+void free_noise_field(NoiseField *field);
+
+/**
+ * @brief Computes the colors of the rows [begin, end) at a given time.
+ *
+ * Uses SSE2 when NOISE_FIELD_SIMD is 1, compute_noise_rows_scalar()
+ * otherwise.
+ *
+ * @param[in,out] field Pointer to the field.
+ * @param[in] begin First row.
+ * @param[in] end End row (excluded).
+ * @param[in] shade Color of the rows.
+ * @param[in] time_s Animation time in seconds (positive).
+ */
+void compute_noise_rows(NoiseField *field, int begin, int end, const NoiseShade *shade, float time_s);
+
+/**
+ * @brief Scalar version of compute_noise_rows(), same colors bit for bit.
+ *
+ * @param[in,out] field Pointer to the field.
+ * @param[in] begin First row.
+ * @param[in] end End row (excluded).
+ * @param[in] shade Color of the rows.
+ * @param[in] time_s Animation time in seconds (positive).
+ */
+void compute_noise_rows_scalar(NoiseField *field, int begin, int end, const NoiseShade *shade, float time_s);
+
+/**
+ * @brief Computes the rows [begin, end) of a frame, each with the shade
+ * of its band.
+ *
+ * @param[in,out] field Pointer to the field.
+ * @param[in] frame Parameters of the frame.
+ * @param[in] begin First row.
+ * @param[in] end End row (excluded).
+ */
+void compute_noise_frame(NoiseField *field, const NoiseFrame *frame, int begin, int end);
+
+/**
+ * @brief Fills the pixels of the tiles of the rows [begin, end) with their colors.
+ *
+ * The image covers the area of the field, the tiles of the last row and
+ * column are cut at its border.
+ *
+ * @param[in] field Pointer to the field, whose rows are computed.
+ * @param[in] target Pixels of the image.
+ * @param[in] begin First row.
+ * @param[in] end End row (excluded).
+ */
+void paint_noise_rows(const NoiseField *field, const NoiseTarget *target, int begin, int end);
+
+#endif /* _NOISE_FIELD_H */
@@ -0,0 +1,154 @@
+#include"noise_pipeline.h"
+
+#include<sched.h>
+
+/*
+ * Claims and computes the bands of the back field until none is left.
+ * The frame and the back field are read after a band is claimed: the
+ * main thread changes them only while no band can be claimed.
+ */
+static void compute_noise_bands(NoisePipeline *pipeline) {
+    int band, begin, back;
+
+    band = __sync_fetch_and_add(&pipeline->next_band, 1);
+
+    while (band < pipeline->bands) {
+        begin = band * NOISE_BAND_ROWS;
+        back = 1 - pipeline->front;
+
+        compute_noise_frame(&pipeline->fields[back], &pipeline->frame,
+                            begin, begin + NOISE_BAND_ROWS);
+        if (pipeline->targets[back].pixels != NULL)
+            paint_noise_rows(&pipeline->fields[back], &pipeline->targets[back],
+                             begin, begin + NOISE_BAND_ROWS);
+
+        __sync_fetch_and_add(&pipeline->done_bands, 1);
+        band = __sync_fetch_and_add(&pipeline->next_band, 1);
+    }
+}
+
+static void* run_noise_worker(void *data) {
+    NoisePipeline *pipeline;
+    unsigned long seen;
+    int running;
+
+    pipeline = (NoisePipeline*) data;
+    seen = 0;
+    running = 1;
+
+    while (running) {
+        pthread_mutex_lock(&pipeline->lock);
+
+        while (pipeline->generation == seen && !pipeline->quit)
+            pthread_cond_wait(&pipeline->wake, &pipeline->lock);
+
+        seen = pipeline->generation;
+        running = !pipeline->quit;
+
+        pthread_mutex_unlock(&pipeline->lock);
+
+        if (running)
+            compute_noise_bands(pipeline);
+    }
+
+    return NULL;
+}
+
+int init_noise_pipeline(NoisePipeline *pipeline, int width, int height, int tile, int threads) {
+    int res, i;
+
+    res = init_noise_field(&pipeline->fields[0], width, height, tile);
+    if (res) {
+        res = init_noise_field(&pipeline->fields[1], width, height, tile);
+        if (!res)
+            free_noise_field(&pipeline->fields[0]);
+    }
+
+    if (res) {
+        pipeline->front = 0;
+        pipeline->targets[0].pixels = NULL;
+        pipeline->targets[1].pixels = NULL;
+        pipeline->bands = (pipeline->fields[0].rows + NOISE_BAND_ROWS - 1) / NOISE_BAND_ROWS;
+        pipeline->next_band = pipeline->bands;
+        pipeline->done_bands = pipeline->bands;
+        pipeline->pending = 0;
+
+        pthread_mutex_init(&pipeline->lock, NULL);
+        pthread_cond_init(&pipeline->wake, NULL);
+        pipeline->generation = 0;
+        pipeline->quit = 0;
+
+        if (threads > NOISE_PIPELINE_MAX_THREADS)
+            threads = NOISE_PIPELINE_MAX_THREADS;
+
+        /* a worker which could not be started is replaced by the main thread */
+        pipeline->threads_count = 0;
+        for (i = 0; i < threads; i++) {
+            if (pthread_create(&pipeline->threads[pipeline->threads_count], NULL,
+                               run_noise_worker, pipeline) == 0)
+                pipeline->threads_count++;
+        }
+    }
+
+    return res;
+}
+
+void free_noise_pipeline(NoisePipeline *pipeline) {
+    int i;
+
+    finish_noise_frame(pipeline);
+
+    pthread_mutex_lock(&pipeline->lock);
+    pipeline->quit = 1;
+    pthread_cond_broadcast(&pipeline->wake);
+    pthread_mutex_unlock(&pipeline->lock);
+
+    for (i = 0; i < pipeline->threads_count; i++)
+        pthread_join(pipeline->threads[i], NULL);
+
+    pthread_mutex_destroy(&pipeline->lock);
+    pthread_cond_destroy(&pipeline->wake);
+
+    free_noise_field(&pipeline->fields[0]);
+    free_noise_field(&pipeline->fields[1]);
+    pipeline->threads_count = 0;
+}
+
+void set_noise_pipeline_target(NoisePipeline *pipeline, int index, const NoiseTarget *target) {
+    pipeline->targets[index] = *target;
+}
+
+void start_noise_frame(NoisePipeline *pipeline, const NoiseFrame *frame) {
+    finish_noise_frame(pipeline);
+
+    /* no band can be claimed here: next_band is past the last one. The
+       reset of next_band (full barrier) publishes the frame and the
+       front index to the workers which claim its bands */
+    pipeline->frame = *frame;
+
+    __sync_fetch_and_and(&pipeline->done_bands, 0);
+    __sync_fetch_and_and(&pipeline->next_band, 0);
+    pipeline->pending = 1;
+
+    if (pipeline->threads_count > 0) {
+        pthread_mutex_lock(&pipeline->lock);
+        pipeline->generation++;
+        pthread_cond_broadcast(&pipeline->wake);
+        pthread_mutex_unlock(&pipeline->lock);
+    }
+}
+
+NoiseField* finish_noise_frame(NoisePipeline *pipeline) {
+    if (pipeline->pending) {
+        compute_noise_bands(pipeline);
+
+        /* bands claimed by the workers and not done yet */
+        while (__sync_fetch_and_add(&pipeline->done_bands, 0) < pipeline->bands)
+            sched_yield();
+
+        pipeline->front = 1 - pipeline->front;
+        pipeline->pending = 0;
+    }
+
+    return &pipeline->fields[pipeline->front];
+}
@@ -0,0 +1,123 @@
+/**
+ * @file noise_pipeline.h
+ * @brief Computes the next frame of the background noise on worker
+ * threads while the current one is presented.
+ *
+ * ## Double buffer
+ * The pipeline owns two fields. The front field holds the last finished
+ * frame and is only read by the main thread (upload to the window). The
+ * back field is written by the workers. start_noise_frame() launches the
+ * computation of a frame in the back field and returns at once;
+ * finish_noise_frame() completes it and swaps the fields. Calling
+ * finish_noise_frame() then start_noise_frame() at the beginning of every
+ * frame computes the background of the next frame during the upload,
+ * the presentation and the sleep of the current one (one frame of
+ * latency).
+ *
+ * ## Bands
+ * A frame is split in bands of NOISE_BAND_ROWS rows. The workers, and
+ * the main thread in finish_noise_frame(), claim the bands one by one
+ * with an atomic counter and count the finished ones with another. The
+ * main thread never waits on a lock for a frame: it computes the bands
+ * nobody claimed yet, then waits for the last claimed ones to be done.
+ * The lock of the pipeline only puts the idle workers to sleep.
+ *
+ * ## Pixels
+ * Each field can be given an image (set_noise_pipeline_target()). The
+ * thread which computes a band then also paints its tiles in the image
+ * of the field, so the main thread only has to present the image of the
+ * front field, whatever the number of tiles.
+ */
+
+#ifndef _NOISE_PIPELINE_H
+#define _NOISE_PIPELINE_H
+
+#include<pthread.h>
+
+#include"noise_field.h"
+
+#define NOISE_PIPELINE_MAX_THREADS 16 /**< Maximum number of worker threads */
+#define NOISE_BAND_ROWS 4             /**< Rows of a band, the unit of work */
+
+/**
+ * @struct NoisePipeline
+ * @brief Worker threads and double buffered fields of the background.
+ */
+typedef struct {
+    NoiseField fields[2];    /**< Front and back fields */
+    NoiseTarget targets[2];  /**< Image of each field, pixels NULL if none */
+    int front;               /**< Index of the front field */
+
+    NoiseFrame frame;        /**< Parameters of the frame of the back field */
+    int bands;               /**< Bands of a frame */
+    volatile int next_band;  /**< Next band to claim (atomic) */
+    volatile int done_bands; /**< Bands of the back field finished (atomic) */
+    int pending;             /**< 1 between start_noise_frame() and finish_noise_frame() */
+
+    pthread_t threads[NOISE_PIPELINE_MAX_THREADS]; /**< Worker threads */
+    int threads_count;       /**< Number of started worker threads */
+    pthread_mutex_t lock;    /**< Protects generation and quit */
+    pthread_cond_t wake;     /**< Signaled when a frame is started or on quit */
+    unsigned long generation;/**< Number of frames started */
+    int quit;                /**< 1 when the workers must stop */
+} NoisePipeline;
+
+/**
+ * @brief Allocates the fields and starts the worker threads.
+ *
+ * With 0 threads, the frames are computed by finish_noise_frame(). If a
+ * thread cannot be created, the pipeline runs with fewer workers. Must
+ * be released with free_noise_pipeline().
+ *
+ * @param[out] pipeline Pointer to the pipeline.
+ * @param[in] width Width of the area in pixels.
+ * @param[in] height Height of the area in pixels.
+ * @param[in] tile Side of a tile in pixels (greater than 0).
+ * @param[in] threads Number of worker threads (0 to NOISE_PIPELINE_MAX_THREADS).
+ * @return int 1 on success, 0 if the allocation failed.
+ */
+int init_noise_pipeline(NoisePipeline *pipeline, int width, int height, int tile, int threads);
+
+/**
+ * @brief Stops the workers and releases the fields.
+ *
+ * @param[in,out] pipeline Pointer to the pipeline.
+ */
+void free_noise_pipeline(NoisePipeline *pipeline);
+
+/**
+ * @brief Gives an image to a field, painted with the bands of its frames.
+ *
+ * Must be called while no frame is pending (before the first
+ * start_noise_frame()). The image must stay valid until
+ * free_noise_pipeline() and must not be read while its field is the
+ * back field.
+ *
+ * @param[in,out] pipeline Pointer to the pipeline.
+ * @param[in] index Index of the field in fields (0 or 1).
+ * @param[in] target Pixels of the image, covering the area of the field.
+ */
+void set_noise_pipeline_target(NoisePipeline *pipeline, int index, const NoiseTarget *target);
+
+/**
+ * @brief Starts the computation of a frame in the back field.
+ *
+ * A frame still pending is finished first.
+ *
+ * @param[in,out] pipeline Pointer to the pipeline.
+ * @param[in] frame Parameters of the frame.
+ */
+void start_noise_frame(NoisePipeline *pipeline, const NoiseFrame *frame);
+
+/**
+ * @brief Completes the pending frame and makes it the front field.
+ *
+ * Without pending frame, the front field is returned unchanged.
+ *
+ * @param[in,out] pipeline Pointer to the pipeline.
+ * @return NoiseField* The front field, valid until the next call of
+ *         finish_noise_frame().
+ */
+NoiseField* finish_noise_frame(NoisePipeline *pipeline);
+
+#endif /* _NOISE_PIPELINE_H */
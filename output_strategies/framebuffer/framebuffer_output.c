@@ -0,0 +1,313 @@
+#include"framebuffer_output.h"
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<ctype.h>
+#include<string.h>
+
+#define FRAMEBUFFER_GLYPH_WIDTH 5
+#define FRAMEBUFFER_GLYPH_HEIGHT 7
+#define FRAMEBUFFER_GLYPH_ADVANCE 6
+
+/* glyphs of the built-in font, one 5 bits row per byte, top row first */
+static const char framebuffer_glyphs_chars[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ:.-";
+static const unsigned char framebuffer_glyphs[][FRAMEBUFFER_GLYPH_HEIGHT] = {
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, /* 0 */
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, /* 1 */
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, /* 2 */
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, /* 3 */
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, /* 4 */
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, /* 5 */
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, /* 6 */
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, /* 7 */
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, /* 8 */
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, /* 9 */
+    { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, /* A */
+    { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E }, /* B */
+    { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, /* C */
+    { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C }, /* D */
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, /* E */
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, /* F */
+    { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, /* G */
+    { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, /* H */
+    { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, /* I */
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C }, /* J */
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, /* K */
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F }, /* L */
+    { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, /* M */
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, /* N */
+    { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, /* O */
+    { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, /* P */
+    { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, /* Q */
+    { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, /* R */
+    { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, /* S */
+    { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, /* T */
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, /* U */
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, /* V */
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A }, /* W */
+    { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, /* X */
+    { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 }, /* Y */
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }, /* Z */
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 }, /* : */
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, /* . */
+    { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 }  /* - */
+};
+
+/*
+ * Blends a color over a pixel with the alpha of the color. The pixel
+ * stays opaque, as the pixels of the window.
+ */
+static uint32_t blend_framebuffer_pixel(uint32_t pixel, uint32_t color) {
+    uint32_t alpha, res, c, p;
+    int shift;
+
+    alpha = color & 0xFF;
+
+    if (alpha == 0xFF) {
+        res = color;
+    } else if (alpha == 0) {
+        res = pixel;
+    } else {
+        res = 0xFF;
+        for (shift = 8; shift <= 24; shift += 8) {
+            c = (color >> shift) & 0xFF;
+            p = (pixel >> shift) & 0xFF;
+            res |= ((c * alpha + p * (255 - alpha) + 127) / 255) << shift;
+        }
+    }
+
+    return res;
+}
+
+/*
+ * Clips the rectangle (x, y, width, height) to the frame, moves the
+ * source point of the same amount. Returns 0 if nothing is left.
+ */
+static int clip_framebuffer_rect(const Framebuffer *framebuffer, int *source_x, int *source_y,
+                                 int *x, int *y, int *width, int *height) {
+    if (*x < 0) {
+        *source_x -= *x;
+        *width += *x;
+        *x = 0;
+    }
+    if (*y < 0) {
+        *source_y -= *y;
+        *height += *y;
+        *y = 0;
+    }
+    if (*x + *width > framebuffer->width)
+        *width = framebuffer->width - *x;
+    if (*y + *height > framebuffer->height)
+        *height = framebuffer->height - *y;
+
+    return *width > 0 && *height > 0;
+}
+
+static void free_framebuffer_image(FramebufferImage *entry) {
+    free(entry->pixels);
+    entry->pixels = NULL;
+    entry->image = NULL;
+}
+
+/*
+ * Returns the pixels of an image, read at its first use. NULL if they
+ * could not be allocated.
+ */
+static FramebufferImage* get_framebuffer_image(Framebuffer *framebuffer, const MLV_Image *image) {
+    FramebufferImage *res, *entry;
+    int i, x, y, r, g, b, a;
+
+    res = NULL;
+    entry = NULL;
+
+    for (i = 0; i < FRAMEBUFFER_MAX_IMAGES && res == NULL; i++) {
+        if (framebuffer->images[i].image == image)
+            res = &framebuffer->images[i];
+        else if (framebuffer->images[i].image == NULL && entry == NULL)
+            entry = &framebuffer->images[i];
+    }
+
+    if (res == NULL) {
+        if (entry == NULL) {
+            entry = &framebuffer->images[framebuffer->next_image];
+            framebuffer->next_image = (framebuffer->next_image + 1) % FRAMEBUFFER_MAX_IMAGES;
+            free_framebuffer_image(entry);
+        }
+
+        MLV_get_image_size(image, &entry->width, &entry->height);
+        entry->pixels = (uint32_t*) malloc((size_t) entry->width * entry->height * sizeof(uint32_t));
+
+        if (entry->pixels != NULL) {
+            for (y = 0; y < entry->height; y++) {
+                for (x = 0; x < entry->width; x++) {
+                    MLV_get_pixel_on_image((MLV_Image*) image, x, y, &r, &g, &b, &a);
+                    entry->pixels[y * entry->width + x] = ((uint32_t) r << 24) | ((uint32_t) g << 16) |
+                                                          ((uint32_t) b << 8) | (uint32_t) a;
+                }
+            }
+
+            entry->image = image;
+            res = entry;
+        }
+    }
+
+    return res;
+}
+
+static void framebuffer_draw_image(OutputStrategy *output, const MLV_Image *image,
+                                   int source_x, int source_y, int width, int height, int x, int y) {
+    Framebuffer *framebuffer;
+    FramebufferImage *source;
+    uint32_t *row;
+    const uint32_t *source_row;
+    int i, j;
+
+    framebuffer = (Framebuffer*) output->data;
+    source = get_framebuffer_image(framebuffer, image);
+
+    if (source != NULL) {
+        /* the part of the image outside of it is not drawn */
+        if (source_x < 0) {
+            x -= source_x;
+            width += source_x;
+            source_x = 0;
+        }
+        if (source_y < 0) {
+            y -= source_y;
+            height += source_y;
+            source_y = 0;
+        }
+        if (source_x + width > source->width)
+            width = source->width - source_x;
+        if (source_y + height > source->height)
+            height = source->height - source_y;
+
+        if (clip_framebuffer_rect(framebuffer, &source_x, &source_y, &x, &y, &width, &height)) {
+            for (j = 0; j < height; j++) {
+                row = framebuffer->pixels + (y + j) * framebuffer->width + x;
+                source_row = source->pixels + (source_y + j) * source->width + source_x;
+
+                for (i = 0; i < width; i++)
+                    row[i] = blend_framebuffer_pixel(row[i], source_row[i]);
+            }
+        }
+    }
+}
+
+static void framebuffer_draw_filled_rectangle(OutputStrategy *output, int x, int y, int width, int height,
+                                              MLV_Color color) {
+    Framebuffer *framebuffer;
+    uint32_t *row;
+    int i, j, source_x, source_y;
+
+    framebuffer = (Framebuffer*) output->data;
+    source_x = 0;
+    source_y = 0;
+
+    if (clip_framebuffer_rect(framebuffer, &source_x, &source_y, &x, &y, &width, &height)) {
+        for (j = 0; j < height; j++) {
+            row = framebuffer->pixels + (y + j) * framebuffer->width + x;
+
+            for (i = 0; i < width; i++)
+                row[i] = blend_framebuffer_pixel(row[i], (uint32_t) color);
+        }
+    }
+}
+
+static void framebuffer_draw_text(OutputStrategy *output, int x, int y, const char *text, MLV_Color color) {
+    const char *glyph;
+    int i, j;
+
+    for (; *text != '\0'; text++, x += FRAMEBUFFER_GLYPH_ADVANCE) {
+        glyph = *text == ' ' ? NULL : strchr(framebuffer_glyphs_chars, toupper((unsigned char) *text));
+
+        if (glyph != NULL) {
+            for (j = 0; j < FRAMEBUFFER_GLYPH_HEIGHT; j++) {
+                for (i = 0; i < FRAMEBUFFER_GLYPH_WIDTH; i++) {
+                    if (framebuffer_glyphs[glyph - framebuffer_glyphs_chars][j] & (0x10 >> i))
+                        framebuffer_draw_filled_rectangle(output, x + i, y + j, 1, 1, color);
+                }
+            }
+        }
+    }
+}
+
+static void framebuffer_present(OutputStrategy *output) {
+    ((Framebuffer*) output->data)->frames++;
+}
+
+static void framebuffer_forget_image(OutputStrategy *output, const MLV_Image *image) {
+    Framebuffer *framebuffer;
+    int i;
+
+    framebuffer = (Framebuffer*) output->data;
+
+    for (i = 0; i < FRAMEBUFFER_MAX_IMAGES; i++) {
+        if (framebuffer->images[i].image == image)
+            free_framebuffer_image(&framebuffer->images[i]);
+    }
+}
+
+int init_framebuffer(Framebuffer *framebuffer, int width, int height) {
+    int i;
+
+    framebuffer->width = width;
+    framebuffer->height = height;
+    framebuffer->frames = 0;
+    framebuffer->next_image = 0;
+
+    for (i = 0; i < FRAMEBUFFER_MAX_IMAGES; i++) {
+        framebuffer->images[i].image = NULL;
+        framebuffer->images[i].pixels = NULL;
+    }
+
+    framebuffer->pixels = (uint32_t*) malloc((size_t) width * height * sizeof(uint32_t));
+
+    for (i = 0; framebuffer->pixels != NULL && i < width * height; i++)
+        framebuffer->pixels[i] = 0xFF;
+
+    return framebuffer->pixels != NULL;
+}
+
+void free_framebuffer(Framebuffer *framebuffer) {
+    int i;
+
+    for (i = 0; i < FRAMEBUFFER_MAX_IMAGES; i++)
+        free_framebuffer_image(&framebuffer->images[i]);
+
+    free(framebuffer->pixels);
+    framebuffer->pixels = NULL;
+}
+
+void init_framebuffer_output(OutputStrategy *output, Framebuffer *framebuffer) {
+    output->data = framebuffer;
+    output->draw_image = framebuffer_draw_image;
+    output->draw_filled_rectangle = framebuffer_draw_filled_rectangle;
+    output->draw_text = framebuffer_draw_text;
+    output->present = framebuffer_present;
+    output->forget_image = framebuffer_forget_image;
+}
+
+int save_framebuffer_ppm(const Framebuffer *framebuffer, const char *path) {
+    FILE *file;
+    uint32_t pixel;
+    int i, res;
+
+    file = fopen(path, "wb");
+    res = file != NULL;
+
+    if (res) {
+        fprintf(file, "P6\n%d %d\n255\n", framebuffer->width, framebuffer->height);
+
+        for (i = 0; i < framebuffer->width * framebuffer->height && res; i++) {
+            pixel = framebuffer->pixels[i];
+            res = fputc((int) (pixel >> 24) & 0xFF, file) != EOF &&
+                  fputc((int) (pixel >> 16) & 0xFF, file) != EOF &&
+                  fputc((int) (pixel >> 8) & 0xFF, file) != EOF;
+        }
+
+        res = fclose(file) == 0 && res;
+    }
+
+    return res;
+}
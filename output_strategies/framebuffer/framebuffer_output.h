@@ -0,0 +1,87 @@
+/**
+ * @file framebuffer_output.h
+ * @brief Output strategy which paints an RGBA buffer in memory.
+ *
+ * No window is needed: the frames are painted in the pixels of the
+ * Framebuffer, which can be saved (save_framebuffer_ppm()) or compared,
+ * and present() only counts them.
+ *
+ * The pixels of an image are read once with MLV_get_pixel_on_image() and
+ * kept, up to FRAMEBUFFER_MAX_IMAGES images, until the image is
+ * forgotten. Images are blended over the buffer with their alpha, like
+ * on the window. Texts are drawn with a built-in 5x7 font (digits,
+ * letters without case and a few signs), not with the font of MLV.
+ */
+
+#ifndef _FRAMEBUFFER_OUTPUT_H
+#define _FRAMEBUFFER_OUTPUT_H
+
+#include<stdint.h>
+
+#include"output_strategy.h"
+
+#define FRAMEBUFFER_MAX_IMAGES 64 /**< Images whose pixels are kept */
+
+/**
+ * @struct FramebufferImage
+ * @brief Pixels read from an MLV_Image.
+ */
+typedef struct {
+    const MLV_Image *image; /**< Image read, NULL if the entry is free */
+    int width;              /**< Width of the image in pixels */
+    int height;             /**< Height of the image in pixels */
+    uint32_t *pixels;       /**< Colors of the image, row by row */
+} FramebufferImage;
+
+/**
+ * @struct Framebuffer
+ * @brief Pixels of a frame and the images read.
+ */
+typedef struct {
+    int width;              /**< Width of the frame in pixels */
+    int height;             /**< Height of the frame in pixels */
+    uint32_t *pixels;       /**< Colors of the frame (0xRRGGBBAA as MLV_Color), row by row */
+    unsigned long frames;   /**< Number of frames presented */
+
+    FramebufferImage images[FRAMEBUFFER_MAX_IMAGES]; /**< Images read */
+    int next_image;         /**< Entry replaced when no entry is free */
+} Framebuffer;
+
+/**
+ * @brief Allocates a framebuffer filled with black.
+ *
+ * Must be released with free_framebuffer().
+ *
+ * @param[out] framebuffer Pointer to the framebuffer.
+ * @param[in] width Width of the frame in pixels.
+ * @param[in] height Height of the frame in pixels.
+ * @return int 1 on success, 0 if the allocation failed.
+ */
+int init_framebuffer(Framebuffer *framebuffer, int width, int height);
+
+/**
+ * @brief Releases the pixels of the frame and of the images read.
+ *
+ * @param[in,out] framebuffer Pointer to the framebuffer.
+ */
+void free_framebuffer(Framebuffer *framebuffer);
+
+/**
+ * @brief Fills a strategy with the operations of a framebuffer.
+ *
+ * @param[out] output Pointer to the strategy.
+ * @param[in] framebuffer Framebuffer painted by the strategy, alive while
+ *            the strategy is used.
+ */
+void init_framebuffer_output(OutputStrategy *output, Framebuffer *framebuffer);
+
+/**
+ * @brief Saves the frame in a binary PPM file (alpha is dropped).
+ *
+ * @param[in] framebuffer Pointer to the framebuffer.
+ * @param[in] path Path of the file.
+ * @return int 1 on success, 0 if the file could not be written.
+ */
+int save_framebuffer_ppm(const Framebuffer *framebuffer, const char *path);
+
+#endif /* _FRAMEBUFFER_OUTPUT_H */
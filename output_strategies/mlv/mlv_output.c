@@ -0,0 +1,39 @@
+#include"mlv_output.h"
+
+#include<stdlib.h>
+
+static void mlv_draw_image(OutputStrategy *output, const MLV_Image *image,
+                           int source_x, int source_y, int width, int height, int x, int y) {
+    (void) output;
+    MLV_draw_partial_image(image, source_x, source_y, width, height, x, y);
+}
+
+static void mlv_draw_filled_rectangle(OutputStrategy *output, int x, int y, int width, int height, MLV_Color color) {
+    (void) output;
+    MLV_draw_filled_rectangle(x, y, width, height, color);
+}
+
+static void mlv_draw_text(OutputStrategy *output, int x, int y, const char *text, MLV_Color color) {
+    (void) output;
+    MLV_draw_text(x, y, "%s", color, text);
+}
+
+static void mlv_present(OutputStrategy *output) {
+    (void) output;
+    MLV_actualise_window();
+}
+
+/* the window reads the images when they are drawn, nothing is kept */
+static void mlv_forget_image(OutputStrategy *output, const MLV_Image *image) {
+    (void) output;
+    (void) image;
+}
+
+void init_mlv_output(OutputStrategy *output) {
+    output->data = NULL;
+    output->draw_image = mlv_draw_image;
+    output->draw_filled_rectangle = mlv_draw_filled_rectangle;
+    output->draw_text = mlv_draw_text;
+    output->present = mlv_present;
+    output->forget_image = mlv_forget_image;
+}
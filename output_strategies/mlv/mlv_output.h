@@ -0,0 +1,20 @@
+/**
+ * @file mlv_output.h
+ * @brief Output strategy which paints the MLV window.
+ */
+
+#ifndef _MLV_OUTPUT_H
+#define _MLV_OUTPUT_H
+
+#include"output_strategy.h"
+
+/**
+ * @brief Fills a strategy with the MLV operations.
+ *
+ * The window must be created before the strategy is used.
+ *
+ * @param[out] output Pointer to the strategy.
+ */
+void init_mlv_output(OutputStrategy *output);
+
+#endif /* _MLV_OUTPUT_H */
@@ -0,0 +1,35 @@
+#include"output_strategy.h"
+#include"mlv/mlv_output.h"
+
+#include<stdlib.h>
+
+static OutputStrategy *current_output = NULL;
+
+OutputStrategy* get_output_strategy() {
+    static OutputStrategy mlv_output;
+    static int mlv_output_ready = 0;
+
+    if (current_output == NULL) {
+        if (!mlv_output_ready) {
+            init_mlv_output(&mlv_output);
+            mlv_output_ready = 1;
+        }
+        current_output = &mlv_output;
+    }
+
+    return current_output;
+}
+
+void set_output_strategy(OutputStrategy *output) {
+    current_output = output;
+}
+
+void free_output_image(MLV_Image *image) {
+    OutputStrategy *output;
+
+    if (image != NULL) {
+        output = get_output_strategy();
+        output->forget_image(output, image);
+        MLV_free_image(image);
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * @file output_strategy.h
+ * @brief Rendering backend of the game screen.
+ *
+ * The game screen does not call MLV to paint the window: it goes through
+ * the current OutputStrategy, a table of the few operations it needs
+ * (blit a part of an image, fill a rectangle, draw a text, present the
+ * frame). Two strategies exist:
+ * - the MLV one (mlv/mlv_output.h), which paints the window and is the
+ *   default;
+ * - the framebuffer one (framebuffer/framebuffer_output.h), which paints
+ *   an RGBA buffer in memory and never touches a window, for headless
+ *   render benchmarks, frame captures and simulations which do not
+ *   present anything.
+ *
+ * The images given to a strategy are MLV_Image. A strategy may keep data
+ * derived from an image (its pixels), found again by the address of the
+ * image: forget_image() must be called when the pixels of an image
+ * change, and an image drawn through a strategy is freed with
+ * free_output_image(), so that a new image at the same address is not
+ * taken for it.
+ */
+
+#ifndef _OUTPUT_STRATEGY_H
+#define _OUTPUT_STRATEGY_H
+
+#include<MLV/MLV_all.h>
+
+/**
+ * @struct OutputStrategy
+ * @brief Operations of a rendering backend and their state.
+ */
+typedef struct OutputStrategy OutputStrategy;
+
+struct OutputStrategy {
+    void *data; /**< State of the strategy */
+
+    /** Draws the rectangle (source_x, source_y, width, height) of an image at (x, y). */
+    void (*draw_image)(OutputStrategy *output, const MLV_Image *image,
+                       int source_x, int source_y, int width, int height, int x, int y);
+    /** Fills a rectangle with a color. */
+    void (*draw_filled_rectangle)(OutputStrategy *output, int x, int y, int width, int height, MLV_Color color);
+    /** Draws a text with the default font, (x, y) being its top left corner. */
+    void (*draw_text)(OutputStrategy *output, int x, int y, const char *text, MLV_Color color);
+    /** Presents the frame. */
+    void (*present)(OutputStrategy *output);
+    /** Drops the data derived from an image, whose pixels changed or which is freed. */
+    void (*forget_image)(OutputStrategy *output, const MLV_Image *image);
+};
+
+/**
+ * @brief Returns the current strategy, the MLV one if none was set.
+ *
+ * @return OutputStrategy* The current strategy.
+ */
+OutputStrategy* get_output_strategy();
+
+/**
+ * @brief Sets the current strategy.
+ *
+ * The caller keeps the strategy alive while it is current.
+ *
+ * @param[in] output The new strategy, NULL for the MLV one.
+ */
+void set_output_strategy(OutputStrategy *output);
+
+/**
+ * @brief Makes the current strategy forget an image, then frees it.
+ *
+ * @param[in] image The image to free, may be NULL.
+ */
+void free_output_image(MLV_Image *image);
+
+#endif /* _OUTPUT_STRATEGY_H */
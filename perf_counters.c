@@ -0,0 +1,210 @@
+#include"perf_counters.h"
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<string.h>
+#include<stdint.h>
+
+#ifdef __linux__
+#include<errno.h>
+#include<unistd.h>
+#include<sys/ioctl.h>
+#include<sys/syscall.h>
+#include<linux/perf_event.h>
+#endif
+
+typedef struct {
+    int fds[PERF_COUNTERS_NUMBER];          /* -1 if the counter is not opened */
+    int slots[PERF_COUNTERS_NUMBER];        /* index of the counter in a group read, -1 if not opened */
+    int count;                              /* counters opened */
+    int leader;                             /* fd of the group leader, -1 if none */
+    int enabled;                            /* 1 between open_perf_counters() and close_perf_counters() */
+
+    uint64_t starts[PERF_SECTIONS_NUMBER][PERF_COUNTERS_NUMBER];
+    int started[PERF_SECTIONS_NUMBER];      /* 1 if the start of the section was read */
+    double sums[PERF_SECTIONS_NUMBER][PERF_COUNTERS_NUMBER];
+    unsigned long calls[PERF_SECTIONS_NUMBER];
+} PerfCounters;
+
+static PerfCounters perf_counters = { { -1, -1, -1, -1 }, { -1, -1, -1, -1 }, 0, -1, 0, { { 0 } }, { 0 }, { { 0 } }, { 0 } };
+
+static const char *perf_counter_names[PERF_COUNTERS_NUMBER] = {
+    "cycles", "instructions", "cache misses", "branch misses"
+};
+
+static const char *perf_section_names[PERF_SECTIONS_NUMBER] = {
+    "update_game", "draw_game"
+};
+
+#ifdef __linux__
+
+/*
+ * Opens one counter of the calling thread in the group of leader (-1 to
+ * lead a new group). Returns the fd, -1 on error.
+ */
+static int open_perf_counter(PERF_COUNTER counter, int leader) {
+    static const uint64_t configs[PERF_COUNTERS_NUMBER] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[counter];
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.disabled = leader == -1; /* the group starts with its leader */
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int) syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+}
+
+/*
+ * Reads the values of the group in order of opening. Returns 1 on success.
+ */
+static int read_perf_group(uint64_t *values) {
+    uint64_t buffer[1 + PERF_COUNTERS_NUMBER];
+    int res;
+
+    res = read(perf_counters.leader, buffer, sizeof(buffer)) > 0 &&
+          buffer[0] == (uint64_t) perf_counters.count;
+
+    if (res)
+        memcpy(values, buffer + 1, perf_counters.count * sizeof(uint64_t));
+
+    return res;
+}
+
+int open_perf_counters() {
+    int i, error;
+
+    error = 0;
+    perf_counters.enabled = 1;
+
+    if (perf_counters.leader == -1) {
+        for (i = 0; i < PERF_COUNTERS_NUMBER; i++) {
+            perf_counters.fds[i] = open_perf_counter((PERF_COUNTER) i, perf_counters.leader);
+
+            if (perf_counters.fds[i] == -1) {
+                error = errno;
+            } else {
+                if (perf_counters.leader == -1)
+                    perf_counters.leader = perf_counters.fds[i];
+                perf_counters.slots[i] = perf_counters.count++;
+            }
+        }
+
+        if (perf_counters.leader == -1) {
+            fprintf(stderr, "Warining : no hardware performance counter (%s)\n", strerror(error));
+        } else {
+            for (i = 0; i < PERF_COUNTERS_NUMBER; i++) {
+                if (perf_counters.fds[i] == -1)
+                    fprintf(stderr, "Warining : hardware performance counter %s unavailable\n",
+                            perf_counter_names[i]);
+            }
+
+            ioctl(perf_counters.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(perf_counters.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    return perf_counters.count;
+}
+
+void close_perf_counters() {
+    int i;
+
+    for (i = 0; i < PERF_COUNTERS_NUMBER; i++) {
+        if (perf_counters.fds[i] != -1)
+            close(perf_counters.fds[i]);
+
+        perf_counters.fds[i] = -1;
+        perf_counters.slots[i] = -1;
+    }
+
+    perf_counters.count = 0;
+    perf_counters.leader = -1;
+    perf_counters.enabled = 0;
+}
+
+#else
+
+static int read_perf_group(uint64_t *values) {
+    (void) values;
+
+    return 0;
+}
+
+int open_perf_counters() {
+    fprintf(stderr, "Warining : hardware performance counters are only read on Linux\n");
+    perf_counters.enabled = 1;
+
+    return 0;
+}
+
+void close_perf_counters() {
+    perf_counters.enabled = 0;
+}
+
+#endif
+
+int are_perf_counters_enabled() {
+    return perf_counters.enabled;
+}
+
+void reset_perf_counters() {
+    int i, j;
+
+    for (i = 0; i < PERF_SECTIONS_NUMBER; i++) {
+        perf_counters.calls[i] = 0;
+        for (j = 0; j < PERF_COUNTERS_NUMBER; j++)
+            perf_counters.sums[i][j] = 0;
+    }
+}
+
+void begin_perf_section(PERF_SECTION section) {
+    perf_counters.started[section] = perf_counters.leader != -1 &&
+                                     read_perf_group(perf_counters.starts[section]);
+}
+
+void end_perf_section(PERF_SECTION section) {
+    uint64_t values[PERF_COUNTERS_NUMBER];
+    int i;
+
+    /* a failed read skips the call */
+    if (perf_counters.started[section] && read_perf_group(values)) {
+        for (i = 0; i < perf_counters.count; i++)
+            perf_counters.sums[section][i] += (double) (values[i] - perf_counters.starts[section][i]);
+        perf_counters.calls[section]++;
+    }
+}
+
+void print_perf_counters_report() {
+    double calls, cycles, instructions;
+    int i, j;
+
+    if (perf_counters.leader != -1) {
+        for (i = 0; i < PERF_SECTIONS_NUMBER; i++) {
+            calls = perf_counters.calls[i] > 0 ? (double) perf_counters.calls[i] : 1.;
+
+            printf("perf %s: %lu calls", perf_section_names[i], perf_counters.calls[i]);
+
+            for (j = 0; j < PERF_COUNTERS_NUMBER; j++) {
+                if (perf_counters.slots[j] == -1)
+                    printf(", %s n/a", perf_counter_names[j]);
+                else
+                    printf(", %.0f %s", perf_counters.sums[i][perf_counters.slots[j]] / calls, perf_counter_names[j]);
+            }
+
+            if (perf_counters.slots[PERF_COUNTER_CYCLES] != -1 && perf_counters.slots[PERF_COUNTER_INSTRUCTIONS] != -1) {
+                cycles = perf_counters.sums[i][perf_counters.slots[PERF_COUNTER_CYCLES]];
+                instructions = perf_counters.sums[i][perf_counters.slots[PERF_COUNTER_INSTRUCTIONS]];
+                printf(", IPC %.2f", cycles > 0 ? instructions / cycles : 0.);
+            }
+
+            printf(" per call\n");
+        }
+    }
+}
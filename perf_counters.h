@@ -0,0 +1,92 @@
+/**
+ * @file perf_counters.h
+ * @brief Hardware performance counters around the simulation tick and the drawing.
+ *
+ * On Linux, the CPU cycles, instructions, cache misses and branch misses
+ * of the process are read with perf_event_open(2), user space only. The
+ * counters are opened as one group, so the four values are read with a
+ * single read(2) at the start and at the end of each section
+ * (begin_perf_section() and end_perf_section()). The differences are
+ * summed per section for the current game and printed per call by
+ * print_perf_counters_report().
+ *
+ * Counters are off until open_perf_counters(). If the kernel refuses them
+ * (no PMU in a virtual machine, perf_event_paranoid, other systems), a
+ * warning is printed once and the game runs without them; a counter
+ * missing alone is reported as n/a.
+ */
+
+#ifndef _PERF_COUNTERS_H
+#define _PERF_COUNTERS_H
+
+/**
+ * @enum PERF_COUNTER
+ * @brief Hardware events counted.
+ */
+typedef enum {
+    PERF_COUNTER_CYCLES = 0,      /**< CPU cycles */
+    PERF_COUNTER_INSTRUCTIONS,    /**< Retired instructions */
+    PERF_COUNTER_CACHE_MISSES,    /**< Last level cache misses */
+    PERF_COUNTER_BRANCH_MISSES,   /**< Mispredicted branches */
+    PERF_COUNTERS_NUMBER
+} PERF_COUNTER;
+
+/**
+ * @enum PERF_SECTION
+ * @brief Measured parts of the game loop.
+ */
+typedef enum {
+    PERF_SECTION_UPDATE = 0, /**< One update_game() call */
+    PERF_SECTION_DRAW,       /**< One draw_game() call */
+    PERF_SECTIONS_NUMBER
+} PERF_SECTION;
+
+/**
+ * @brief Opens the counters of the process.
+ *
+ * Prints a warning if no counter is available.
+ *
+ * @return int Number of counters opened (0 to PERF_COUNTERS_NUMBER).
+ */
+int open_perf_counters();
+
+/**
+ * @brief Closes the counters, the sections are not measured any more.
+ */
+void close_perf_counters();
+
+/**
+ * @brief Returns 1 if the counters were asked for.
+ *
+ * @return int 1 after open_perf_counters(), even if no counter could be
+ *         opened, 0 otherwise.
+ */
+int are_perf_counters_enabled();
+
+/**
+ * @brief Resets the sums of the sections, at the start of a game.
+ */
+void reset_perf_counters();
+
+/**
+ * @brief Reads the counters at the start of a section.
+ *
+ * @param[in] section The section.
+ */
+void begin_perf_section(PERF_SECTION section);
+
+/**
+ * @brief Reads the counters at the end of a section and adds the differences to its sums.
+ *
+ * @param[in] section The section, started by begin_perf_section().
+ */
+void end_perf_section(PERF_SECTION section);
+
+/**
+ * @brief Prints the counters per call of each section since reset_perf_counters().
+ *
+ * Prints nothing if the counters are not opened.
+ */
+void print_perf_counters_report();
+
+#endif /* _PERF_COUNTERS_H */
@@ -0,0 +1,313 @@
+#include"game_batch.h"
+
+#include<pthread.h>
+
+#include"game_update.h"
+#include"game_bot.h"
+
+#define BATCH_CACHE_LINE 64 /**< Padding between the workers, so their ranges are not on a shared cache line */
+
+/*
+ * A worker thread and the range of games it has not started yet.
+ */
+typedef struct BatchWorker {
+    pthread_mutex_t lock;      /* protects next and end */
+    int next;                  /* first game of the range */
+    int end;                   /* end of the range (excluded) */
+
+    int index;                 /* index of the worker in the pool */
+    int threads;               /* number of workers of the pool */
+    struct BatchWorker *pool;  /* all the workers */
+    GameBatch *batch;
+    unsigned long steals;
+
+    char padding[BATCH_CACHE_LINE];
+} BatchWorker;
+
+int init_game_batch(GameBatch *batch, int count, const GameBatchSettings *settings) {
+    int res, i;
+
+    batch->settings = *settings;
+    batch->count = count;
+    batch->steals = 0;
+
+    batch->ticks = NULL;
+    batch->scores = NULL;
+    batch->status = NULL;
+
+    res = count > 0;
+
+    if (res) {
+        batch->ticks = (unsigned long*) malloc(count * sizeof(unsigned long));
+        batch->scores = (unsigned int*) malloc(count * sizeof(unsigned int));
+        batch->status = (unsigned char*) malloc(count * sizeof(unsigned char));
+
+        res = batch->ticks != NULL && batch->scores != NULL && batch->status != NULL;
+    }
+
+    if (res) {
+        for (i = 0; i < count; i++) {
+            batch->ticks[i] = 0;
+            batch->scores[i] = 0;
+            batch->status[i] = BATCH_GAME_PENDING;
+        }
+    } else {
+        free_game_batch(batch);
+    }
+
+    return res;
+}
+
+void free_game_batch(GameBatch *batch) {
+    free(batch->ticks);
+    free(batch->scores);
+    free(batch->status);
+
+    batch->ticks = NULL;
+    batch->scores = NULL;
+    batch->status = NULL;
+    batch->count = 0;
+}
+
+/*
+ * Returns 1 while a player snake of the game is alive.
+ */
+static int has_alive_player(GameConfig *config) {
+    int i, res;
+
+    res = 0;
+    for (i = 0; i < config->players_count && !res; i++)
+        res = config->snakes[i].is_alive;
+
+    return res;
+}
+
+void play_batch_game(GameBatch *batch, int index, GameConfig *config) {
+    GameBatchSettings *settings;
+    unsigned long seed, tick;
+    int i, res;
+
+    settings = &batch->settings;
+    seed = settings->seed + (unsigned long) index;
+
+    /* the arena of the previous game of the worker is reused */
+    if (config->arena != NULL)
+        res = restart_game(config, seed);
+    else if (settings->bots == 0)
+        res = init_game(config, (GAME_MODE) settings->players,
+                        settings->width, settings->height, seed);
+    else
+        res = init_arena_game(config, settings->players, settings->bots,
+                              settings->width, settings->height, seed);
+
+    if (!res) {
+        batch->status[index] = BATCH_GAME_FAILED;
+    } else {
+        tick = 0;
+
+        while (tick < settings->max_ticks && has_alive_player(config) && !config->board_full) {
+            /* the players are played by the bot */
+            for (i = 0; i < config->players_count; i++) {
+                if (config->snakes[i].is_alive)
+                    update_bot(config, config->snakes + i);
+            }
+
+            update_game(config);
+            tick++;
+        }
+
+        batch->ticks[index] = tick;
+        batch->scores[index] = config->score;
+
+        if (config->board_full)
+            batch->status[index] = BATCH_GAME_WON;
+        else if (!has_alive_player(config))
+            batch->status[index] = BATCH_GAME_OVER;
+        else
+            batch->status[index] = BATCH_GAME_TIMEOUT;
+    }
+}
+
+/*
+ * Takes the next game of the range of a worker.
+ * Returns 0 if its range is empty.
+ */
+static int take_batch_game(BatchWorker *worker, int *index) {
+    int res;
+
+    pthread_mutex_lock(&worker->lock);
+
+    res = worker->next < worker->end;
+    if (res) {
+        *index = worker->next;
+        worker->next++;
+    }
+
+    pthread_mutex_unlock(&worker->lock);
+
+    return res;
+}
+
+/*
+ * Moves the second half of the range of another worker to the (empty)
+ * range of the worker and takes its first game.
+ * Returns 0 if every other range is empty.
+ */
+static int steal_batch_games(BatchWorker *worker, int *index) {
+    BatchWorker *victim;
+    int i, begin, end, res;
+
+    res = 0;
+    begin = 0;
+    end = 0;
+
+    for (i = 1; i < worker->threads && !res; i++) {
+        victim = worker->pool + (worker->index + i) % worker->threads;
+
+        pthread_mutex_lock(&victim->lock);
+
+        end = victim->end;
+        begin = victim->next + (victim->end - victim->next) / 2;
+
+        res = begin < end;
+        if (res)
+            victim->end = begin;
+
+        pthread_mutex_unlock(&victim->lock);
+    }
+
+    if (res) {
+        /* never hold two locks: the range is empty, nobody steals from it meanwhile */
+        pthread_mutex_lock(&worker->lock);
+        *index = begin;
+        worker->next = begin + 1;
+        worker->end = end;
+        pthread_mutex_unlock(&worker->lock);
+
+        worker->steals++;
+    }
+
+    return res;
+}
+
+static void* run_batch_worker(void *data) {
+    BatchWorker *worker;
+    GameConfig config;
+    int index;
+
+    worker = (BatchWorker*) data;
+    config.arena = NULL;
+
+    while (take_batch_game(worker, &index) || steal_batch_games(worker, &index))
+        play_batch_game(worker->batch, index, &config);
+
+    free_game(&config);
+
+    return NULL;
+}
+
+int run_game_batch(GameBatch *batch, int threads) {
+    BatchWorker *pool;
+    pthread_t *ids;
+    int *started;
+    int i, res;
+
+    if (threads < 1)
+        threads = 1;
+    else if (threads > BATCH_MAX_THREADS)
+        threads = BATCH_MAX_THREADS;
+
+    pool = (BatchWorker*) malloc(threads * sizeof(BatchWorker));
+    ids = (pthread_t*) malloc(threads * sizeof(pthread_t));
+    started = (int*) malloc(threads * sizeof(int));
+
+    res = pool != NULL && ids != NULL && started != NULL;
+
+    if (res) {
+        batch->steals = 0;
+
+        for (i = 0; i < threads; i++) {
+            pthread_mutex_init(&pool[i].lock, NULL);
+            pool[i].next = (int) ((double) batch->count * i / threads);
+            pool[i].end = (int) ((double) batch->count * (i + 1) / threads);
+            pool[i].index = i;
+            pool[i].threads = threads;
+            pool[i].pool = pool;
+            pool[i].batch = batch;
+            pool[i].steals = 0;
+        }
+
+        /* the calling thread is the worker 0: the games of a worker which
+           could not be started are stolen by the others */
+        for (i = 1; i < threads; i++)
+            started[i] = pthread_create(ids + i, NULL, run_batch_worker, pool + i) == 0;
+
+        run_batch_worker(pool);
+
+        for (i = 1; i < threads; i++) {
+            if (started[i])
+                pthread_join(ids[i], NULL);
+        }
+
+        for (i = 0; i < threads; i++) {
+            batch->steals += pool[i].steals;
+            pthread_mutex_destroy(&pool[i].lock);
+        }
+    }
+
+    free(pool);
+    free(ids);
+    free(started);
+
+    return res;
+}
+
+void get_game_batch_stats(GameBatch *batch, GameBatchStats *stats) {
+    double score_sum;
+    int i;
+
+    stats->games = 0;
+    stats->over = 0;
+    stats->won = 0;
+    stats->timeout = 0;
+    stats->failed = 0;
+    stats->total_ticks = 0;
+    stats->max_ticks = 0;
+    stats->max_score = 0;
+    score_sum = 0;
+
+    for (i = 0; i < batch->count; i++) {
+        switch (batch->status[i]) {
+        case BATCH_GAME_OVER:
+            stats->over++;
+            break;
+        case BATCH_GAME_WON:
+            stats->won++;
+            break;
+        case BATCH_GAME_TIMEOUT:
+            stats->timeout++;
+            break;
+        case BATCH_GAME_FAILED:
+            stats->failed++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        stats->total_ticks += batch->ticks[i];
+        if (batch->ticks[i] > stats->max_ticks)
+            stats->max_ticks = batch->ticks[i];
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        score_sum += batch->scores[i];
+        if (batch->scores[i] > stats->max_score)
+            stats->max_score = batch->scores[i];
+    }
+
+    stats->games = stats->over + stats->won + stats->timeout;
+    stats->mean_ticks = stats->games > 0 ? stats->total_ticks / stats->games : 0;
+    stats->mean_score = stats->games > 0 ? score_sum / stats->games : 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file game_batch.h
+ * @brief Headless runner of many independent games on all the cores.
+ *
+ * A batch plays `count` games with the same settings and different seeds
+ * (game `i` is seeded with `settings.seed + i`), so its results do not
+ * depend on the number of threads nor on the order the games are played.
+ * The player snakes are driven by the bot of game_bot.h, the games follow
+ * the rules of update_game().
+ *
+ * ## Layout
+ * Only the results are stored as a structure of arrays: one array per
+ * field, indexed by game, so aggregating a field over thousands of games
+ * reads one contiguous array.
+ *
+ * The game states are not: games are not stepped together through
+ * per-field arrays (positions, directions, timers of every game). A
+ * state is mostly variable-length data (the ring buffers of the snakes,
+ * the occupancy grid, the free cells) and the games end after very
+ * different numbers of ticks, so a lockstep layout would need its own
+ * copy of the rules of update_game(). Instead each worker plays one game
+ * at a time in its own GameConfig. The arena of a worker is allocated
+ * once and reused by all its games (restart_game()), so its grid and
+ * snake buffers stay in the cache of its core, and the games scale with
+ * the workers because they share nothing but the ranges of the work
+ * stealing.
+ *
+ * ## Work stealing
+ * The games are split in equal ranges, one per worker thread. A worker
+ * takes its games from the front of its range; when its range is empty it
+ * steals the second half of the remaining range of another worker. Since
+ * the length of a game varies a lot, this keeps all the cores busy until
+ * the end of the batch.
+ */
+#ifndef _GAME_BATCH_H
+#define _GAME_BATCH_H
+
+#include<stdlib.h>
+
+#include"game_config.h"
+
+#define BATCH_MAX_THREADS 256 /**< Maximum number of worker threads */
+
+/**
+ * @enum BATCH_GAME_STATUS
+ * @brief How a game of a batch ended.
+ */
+typedef enum {
+    BATCH_GAME_PENDING = 0, /**< Not played yet. */
+    BATCH_GAME_OVER,        /**< All the player snakes died. */
+    BATCH_GAME_WON,         /**< No free cell left for an apple. */
+    BATCH_GAME_TIMEOUT,     /**< Stopped after settings.max_ticks ticks. */
+    BATCH_GAME_FAILED       /**< The game could not be started. */
+} BATCH_GAME_STATUS;
+
+/**
+ * @struct GameBatchSettings
+ * @brief Settings shared by all the games of a batch.
+ *
+ * With no bot, the games are started by init_game() (single or two player
+ * mode), otherwise by init_arena_game().
+ */
+typedef struct {
+    int players;             /**< Scored snakes, 1 or 2 */
+    int bots;                /**< Additional bot snakes */
+    int width;               /**< Number of columns of the grid */
+    int height;              /**< Number of rows of the grid */
+    unsigned long max_ticks; /**< Longest game, in ticks */
+    unsigned long seed;      /**< Seed of the first game */
+} GameBatchSettings;
+
+/**
+ * @struct GameBatch
+ * @brief Results of a batch, one entry per game in each array.
+ */
+typedef struct {
+    GameBatchSettings settings; /**< Settings of every game */
+    int count;                  /**< Number of games */
+
+    unsigned long *ticks;       /**< Ticks played */
+    unsigned int *scores;       /**< Final score */
+    unsigned char *status;      /**< BATCH_GAME_STATUS */
+
+    unsigned long steals;       /**< Number of ranges stolen by the workers during the last run */
+} GameBatch;
+
+/**
+ * @struct GameBatchStats
+ * @brief Aggregate results of a batch.
+ */
+typedef struct {
+    int games;                /**< Number of finished games */
+    int over;                 /**< Games ended by the death of the players */
+    int won;                  /**< Games ended by a full board */
+    int timeout;              /**< Games stopped after max_ticks */
+    int failed;               /**< Games which could not be started */
+
+    double total_ticks;       /**< Ticks played by all the games */
+    double mean_ticks;        /**< Mean game length in ticks */
+    unsigned long max_ticks;  /**< Longest game in ticks */
+    double mean_score;        /**< Mean score */
+    unsigned int max_score;   /**< Best score */
+} GameBatchStats;
+
+/**
+ * @brief Allocates the result arrays of a batch, all games pending.
+ *
+ * Must be released with free_game_batch().
+ *
+ * @param[out] batch Pointer to the batch.
+ * @param[in] count Number of games (greater than 0).
+ * @param[in] settings Settings of the games.
+ * @return int 1 on success, 0 if the allocation failed.
+ */
+int init_game_batch(GameBatch *batch, int count, const GameBatchSettings *settings);
+
+/**
+ * @brief Releases the result arrays of a batch.
+ *
+ * @param[in,out] batch Pointer to the batch.
+ */
+void free_game_batch(GameBatch *batch);
+
+/**
+ * @brief Plays a single game of a batch in a caller provided GameConfig.
+ *
+ * The game is started, played until its end and its results are stored
+ * at `index`. If config holds a game of the same batch, its arena is
+ * reused (restart_game()), otherwise one is allocated. The arena is kept
+ * for the next game and must be released with free_game().
+ *
+ * @param[in,out] batch Pointer to the batch.
+ * @param[in] index Index of the game, between 0 and batch->count - 1.
+ * @param[in,out] config Game state used while playing, its arena NULL
+ *                before the first game.
+ */
+void play_batch_game(GameBatch *batch, int index, GameConfig *config);
+
+/**
+ * @brief Plays all the games of a batch on a pool of threads.
+ *
+ * The calling thread is one of the workers. If a thread cannot be
+ * created, its games are played by the other workers.
+ *
+ * @param[in,out] batch Pointer to the batch.
+ * @param[in] threads Number of worker threads (1 to BATCH_MAX_THREADS).
+ * @return int 1 on success, 0 if the allocation of the pool failed
+ *         (no game is played).
+ */
+int run_game_batch(GameBatch *batch, int threads);
+
+/**
+ * @brief Aggregates the results of a batch.
+ *
+ * @param[in] batch Pointer to the batch.
+ * @param[out] stats Aggregate results (the pending games are ignored).
+ */
+void get_game_batch_stats(GameBatch *batch, GameBatchStats *stats);
+
+#endif /* _GAME_BATCH_H */
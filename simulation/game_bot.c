@@ -0,0 +1,106 @@
+#include"game_bot.h"
+
+/*
+ * Returns the cell next to pos in a direction, wrapped around the grid.
+ */
+static vector2i get_next_cell(OccupancyGrid *grid, vector2i pos, SnakeDirection direction) {
+    switch (direction) {
+    case SNAKE_DIRECTION_TOP:
+        pos.y = pos.y == 0 ? grid->height - 1 : pos.y - 1;
+        break;
+    case SNAKE_DIRECTION_BOTTOM:
+        pos.y = pos.y == grid->height - 1 ? 0 : pos.y + 1;
+        break;
+    case SNAKE_DIRECTION_LEFT:
+        pos.x = pos.x == 0 ? grid->width - 1 : pos.x - 1;
+        break;
+    case SNAKE_DIRECTION_RIGTH:
+        pos.x = pos.x == grid->width - 1 ? 0 : pos.x + 1;
+        break;
+    default:
+        break;
+    }
+
+    return pos;
+}
+
+/*
+ * Distance between two cells along one axis, the grid being a torus.
+ */
+static int get_wrapped_distance(int a, int b, int size) {
+    int res;
+
+    res = a < b ? b - a : a - b;
+    if (size - res < res)
+        res = size - res;
+
+    return res;
+}
+
+/*
+ * Distance from pos to the nearest apple, -1 if there is no apple.
+ */
+static int get_apple_distance(GameConfig *config, vector2i pos) {
+    GameObject *object;
+    int i, distance, res;
+
+    res = -1;
+
+    for (i = 0; i < GAME_OBJECTS_NUMBER; i++) {
+        object = &config->objects[i];
+
+        if (object->type == GAME_OBJECT_APPLE) {
+            distance = get_wrapped_distance(pos.x, object->pos.x, config->grid.width) +
+                       get_wrapped_distance(pos.y, object->pos.y, config->grid.height);
+
+            if (res == -1 || distance < res)
+                res = distance;
+        }
+    }
+
+    return res;
+}
+
+void update_bot(GameConfig *config, Snake *snake) {
+    SnakeDirection moves[3], best;
+    vector2i head_p, next_p;
+    int i, safe_count, distance, best_distance;
+    SnakeDirection safe[3];
+
+    head_p = *get_snake_head_position(snake);
+
+    /* straight, then the two turns */
+    moves[0] = get_snake_direction(snake);
+    if (moves[0] == SNAKE_DIRECTION_TOP || moves[0] == SNAKE_DIRECTION_BOTTOM) {
+        moves[1] = SNAKE_DIRECTION_LEFT;
+        moves[2] = SNAKE_DIRECTION_RIGTH;
+    } else {
+        moves[1] = SNAKE_DIRECTION_TOP;
+        moves[2] = SNAKE_DIRECTION_BOTTOM;
+    }
+
+    best = moves[0];
+    best_distance = -1;
+    safe_count = 0;
+
+    for (i = 0; i < 3; i++) {
+        next_p = get_next_cell(&config->grid, head_p, moves[i]);
+
+        if (get_cell_owner(&config->grid, next_p) == OCCUPANCY_NO_OWNER) {
+            safe[safe_count] = moves[i];
+            safe_count++;
+
+            distance = get_apple_distance(config, next_p);
+            if (best_distance == -1 || distance < best_distance) {
+                best = moves[i];
+                best_distance = distance;
+            }
+        }
+    }
+
+    if (safe_count > 1 &&
+        game_random_range(&config->random, 100) < BOT_RANDOM_TURN_CHANCE)
+        best = safe[game_random_range(&config->random, safe_count)];
+
+    set_snake_direction(snake, best);
+}
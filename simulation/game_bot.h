@@ -0,0 +1,29 @@
+/**
+ * @file game_bot.h
+ * @brief Computer controlled snakes.
+ *
+ * A bot only looks at the cells next to its head and at the apples of the
+ * game, so choosing its direction takes constant time, whatever the size
+ * of the grid and the number of snakes.
+ */
+#ifndef _GAME_BOT_H
+#define _GAME_BOT_H
+
+#include"game_config.h"
+
+#define BOT_RANDOM_TURN_CHANCE 5 /**< Chance (0–100) for a bot to take a random safe turn */
+
+/**
+ * @brief Chooses the next direction of a bot.
+ *
+ * Among going straight, turning left and turning right, the bot keeps the
+ * moves whose next cell is not covered by a snake and takes the one
+ * closest to the nearest apple (or, sometimes, a random one).
+ * If every move is blocked, the direction is left unchanged.
+ *
+ * @param[in,out] config Pointer to the game configuration.
+ * @param[in,out] snake Bot snake of config->snakes.
+ */
+void update_bot(GameConfig *config, Snake *snake);
+
+#endif /* _GAME_BOT_H */
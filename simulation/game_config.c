@@ -0,0 +1,330 @@
+#include"game_config.h"
+
+
+/*
+ * Adds an object to the list of the portals on the board, if not already in.
+ */
+static void add_portal(GameConfig *game_config, int index) {
+    if (game_config->portal_slot[index] == GAME_NO_PORTAL_SLOT) {
+        game_config->portal_slot[index] = game_config->portals_count;
+        game_config->portals[game_config->portals_count] = index;
+        game_config->portals_count++;
+    }
+}
+
+/*
+ * Removes an object from the list of the portals on the board, the last
+ * portal of the list takes its slot.
+ */
+static void remove_portal(GameConfig *game_config, int index) {
+    int slot, last;
+
+    slot = game_config->portal_slot[index];
+
+    if (slot != GAME_NO_PORTAL_SLOT) {
+        game_config->portals_count--;
+        last = game_config->portals[game_config->portals_count];
+
+        game_config->portals[slot] = last;
+        game_config->portal_slot[last] = slot;
+        game_config->portal_slot[index] = GAME_NO_PORTAL_SLOT;
+    }
+}
+
+/*
+ * Resets the counters of a new game and removes all the objects.
+ */
+static void reset_game_state(GameConfig *game_config) {
+    int i;
+
+    game_config->move_timer = MOVE_TIME;
+    game_config->force_exit = 0;
+    game_config->board_full = 0;
+    game_config->score = 0;
+
+    for (i = 0; i < GAME_OBJECTS_NUMBER; i++) {
+        game_config->objects[i].type = GAME_OBJECT_NONE;
+        game_config->objects[i].pos = create_vector2i(-1, -1);
+        game_config->portal_slot[i] = GAME_NO_PORTAL_SLOT;
+    }
+    game_config->portals_count = 0;
+}
+
+/*
+ * Puts the snakes and the objects of a new player game in a freshly
+ * allocated arena.
+ */
+static void setup_game(GameConfig *game_config) {
+    GAME_MODE game_mode;
+    Snake *snakes;
+
+    game_mode = game_config->game_mode;
+    snakes = game_config->snakes;
+
+    reset_game_state(game_config);
+    
+    snakes[0] = create_snake(snakes[0].items, snakes[0].capacity);
+    move_and_expand_snake(&snakes[0]);
+
+    if (game_mode == GAME_TWO_PLAYER_MODE) {
+        snakes[1] = create_snake(snakes[1].items, snakes[1].capacity);
+
+        get_snake_head_position(&snakes[1])->x = 7;
+        move_and_expand_snake(&snakes[1]);
+    }
+
+    game_config->objects[0].type = GAME_OBJECT_APPLE;
+    game_config->objects[2].type = GAME_OBJECT_PORTAL;
+    game_config->objects[3].type = GAME_OBJECT_PORTAL;
+
+    rebuild_occupancy_grid(game_config);
+    
+    if (game_mode == GAME_TWO_PLAYER_MODE) {
+        game_config->objects[1].type = GAME_OBJECT_APPLE;
+        place_game_object(game_config, &game_config->objects[1]);
+        game_config->objects[4].type = GAME_OBJECT_PORTAL;
+
+        place_game_object(game_config, &game_config->objects[1]);
+        place_game_object(game_config, &game_config->objects[4]);
+    }
+    
+    place_game_object(game_config, &game_config->objects[0]);
+    place_game_object(game_config, &game_config->objects[2]);
+
+    place_game_object(game_config, &game_config->objects[3]);
+}
+
+/*
+ * Spreads the snakes of a new arena game on random free cells, then
+ * places two apples and three portals.
+ */
+static void setup_arena_game(GameConfig *game_config) {
+    Snake *snake;
+    int i;
+
+    reset_game_state(game_config);
+
+    for (i = 0; i < game_config->snakes_count; i++) {
+        snake = game_config->snakes + i;
+
+        *snake = create_snake(snake->items, snake->capacity);
+        respawn_snake(game_config, snake);
+    }
+
+    for (i = 0; i < GAME_OBJECTS_NUMBER; i++) {
+        game_config->objects[i].type = i < 2 ? GAME_OBJECT_APPLE : GAME_OBJECT_PORTAL;
+        place_game_object(game_config, &game_config->objects[i]);
+    }
+}
+
+int init_game(GameConfig *game_config, GAME_MODE game_mode, int width, int height, unsigned long seed) {
+    int res;
+
+    game_config->game_mode = game_mode;
+    game_config->snakes_count = (int) game_mode;
+    game_config->players_count = (int) game_mode;
+
+    res = (game_mode == GAME_SINGLE_PLAYER_MODE || game_mode == GAME_TWO_PLAYER_MODE) &&
+          alloc_game_arena(game_config, width, height);
+
+    if (res) {
+        seed_game_random(&game_config->random, seed);
+        setup_game(game_config);
+    }
+
+    return res;
+}
+
+int init_arena_game(GameConfig *game_config, int players, int bots,
+                    int width, int height, unsigned long seed) {
+    int res;
+
+    game_config->game_mode = GAME_ARENA_MODE;
+    game_config->snakes_count = players + bots;
+    game_config->players_count = players;
+
+    res = 0 <= players && players <= 2 && 0 <= bots &&
+          0 < players + bots && players + bots <= GAME_MAX_SNAKES &&
+          (players + bots) * 4 <= width * height &&
+          alloc_game_arena(game_config, width, height);
+
+    if (res) {
+        seed_game_random(&game_config->random, seed);
+        setup_arena_game(game_config);
+    }
+
+    return res;
+}
+
+int restart_game(GameConfig *game_config, unsigned long seed) {
+    int i, res;
+
+    res = game_config->arena != NULL;
+
+    if (res) {
+        /* the snakes of the last game are not on the new grid */
+        for (i = 0; i < game_config->snakes_count; i++)
+            game_config->snakes[i].grid = NULL;
+        clear_occupancy_grid(&game_config->grid);
+
+        seed_game_random(&game_config->random, seed);
+
+        if (game_config->game_mode == GAME_ARENA_MODE)
+            setup_arena_game(game_config);
+        else
+            setup_game(game_config);
+    }
+
+    return res;
+}
+
+int alloc_game_arena(GameConfig *game_config, int width, int height) {
+    OccupancyCell *cells;
+    Snake *snakes;
+    vector2i *items;
+    int *free_cells;
+    size_t area, count, capacity, i;
+    int res;
+
+    res = 0;
+    game_config->arena = NULL;
+
+    if (MIN_GRID_SIZE <= width && width <= MAX_GRID_SIZE &&
+        MIN_GRID_SIZE <= height && height <= MAX_GRID_SIZE &&
+        0 < game_config->snakes_count && game_config->snakes_count <= GAME_MAX_SNAKES) {
+
+        area = (size_t) width * height;
+        count = (size_t) game_config->snakes_count;
+        capacity = (count <= 2 ? area : 2 * area / count) + SNAKE_ROLLBACK_SIZE;
+
+        /* strictest alignment first: cells, snakes, then the positions and the indices */
+        game_config->arena = malloc(area * sizeof(OccupancyCell) +
+                                    count * sizeof(Snake) +
+                                    count * capacity * sizeof(vector2i) +
+                                    2 * area * sizeof(int));
+
+        if (game_config->arena != NULL) {
+            cells = (OccupancyCell*) game_config->arena;
+            snakes = (Snake*) (cells + area);
+            items = (vector2i*) (snakes + count);
+            free_cells = (int*) (items + count * capacity);
+
+            init_occupancy_grid(&game_config->grid, width, height,
+                                cells, free_cells, free_cells + area);
+
+            game_config->snakes = snakes;
+
+            for (i = 0; i < count; i++) {
+                snakes[i].items = items + i * capacity;
+                snakes[i].capacity = capacity;
+                snakes[i].grid = NULL;
+            }
+
+            res = 1;
+        }
+    }
+
+    return res;
+}
+
+void free_game(GameConfig *game_config) {
+    free(game_config->arena);
+    game_config->arena = NULL;
+}
+
+void rebuild_occupancy_grid(GameConfig *game_config) {
+    int i;
+
+    clear_occupancy_grid(&game_config->grid);
+
+    for (i = 0; i < game_config->snakes_count; i++)
+        attach_snake_to_grid(game_config->snakes + i, &game_config->grid, (unsigned short) (i + 1));
+
+    game_config->portals_count = 0;
+
+    for (i = 0; i < GAME_OBJECTS_NUMBER; i++) {
+        game_config->portal_slot[i] = GAME_NO_PORTAL_SLOT;
+
+        if (game_config->objects[i].type != GAME_OBJECT_NONE)
+            set_cell_object(&game_config->grid, game_config->objects[i].pos, i + 1);
+
+        if (game_config->objects[i].type == GAME_OBJECT_PORTAL && is_in_grid(&game_config->grid, game_config->objects[i].pos))
+            add_portal(game_config, i);
+    }
+}
+
+int place_game_object(GameConfig *game_config, GameObject *object) {
+    OccupancyGrid *grid;
+    OccupancyCell *cell;
+    unsigned short object_id;
+    int free_count, res;
+
+    grid = &game_config->grid;
+    object_id = (unsigned short) (object - game_config->objects) + 1;
+
+    /* leave the current cell */
+    cell = get_occupancy_cell(grid, object->pos);
+    if (cell != NULL && cell->object == object_id)
+        set_cell_object(grid, object->pos, OCCUPANCY_NO_OBJECT);
+
+    free_count = get_free_cell_count(grid);
+
+    if (free_count == 0) {
+        object->type = GAME_OBJECT_NONE;
+        object->pos = create_vector2i(-1, -1);
+        res = 0;
+    } else {
+        object->pos = get_free_cell(grid, game_random_range(&game_config->random, free_count));
+        set_cell_object(grid, object->pos, object_id);
+        res = 1;
+    }
+
+    if (object->type == GAME_OBJECT_PORTAL)
+        add_portal(game_config, object_id - 1);
+    else
+        remove_portal(game_config, object_id - 1);
+
+    return res;
+}
+
+void replace_portals(GameConfig *config) {
+    GameObject *object;
+    int i;
+
+    /* backwards: a portal removed from the list (full board) is replaced by one already visited */
+    for (i = config->portals_count - 1; i >= 0; i--) {
+        object = config->objects + config->portals[i];
+
+        if (get_cell_owner(&config->grid, object->pos) == OCCUPANCY_NO_OWNER)
+            place_game_object(config, object);
+    }
+}
+
+int respawn_snake(GameConfig *config, Snake *snake) {
+    const SnakeDirection directions[4] = {
+        SNAKE_DIRECTION_TOP, SNAKE_DIRECTION_BOTTOM,
+        SNAKE_DIRECTION_LEFT, SNAKE_DIRECTION_RIGTH
+    };
+    OccupancyGrid *grid;
+    int free_count, res;
+
+    grid = &config->grid;
+
+    detach_snake_from_grid(snake);
+    free_count = get_free_cell_count(grid);
+
+    if (free_count == 0) {
+        res = 0;
+    } else {
+        *snake = create_snake(snake->items, snake->capacity);
+
+        snake->items[0] = get_free_cell(grid, game_random_range(&config->random, free_count));
+        snake->direction = directions[game_random_range(&config->random, 4)];
+        snake->to_rotate = snake->direction;
+
+        attach_snake_to_grid(snake, grid, (unsigned short) (snake - config->snakes + 1));
+        res = 1;
+    }
+
+    return res;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file game_config.h
+ * @brief Configuration and initialization for the Snake game.
+ *
+ * This file defines the game settings, constants, modes, and the main
+ * GameConfig structure. It also provides functions to initialize the game,
+ * set up the snakes, and place apples on the grid.
+ *
+ * GameConfig is plain data: it holds no image, color or window resource,
+ * so the simulation runs without MLV. The front-end keeps its render data
+ * in a parallel GameView.
+ */
+
+#ifndef _GAME_CONFIG_H
+#define _GAME_CONFIG_H
+
+#define GAME_OBJECTS_NUMBER 5 /**< Maximum number of game objects */
+#define GAME_MAX_SNAKES 256   /**< Maximum number of snakes (players and bots) of a game */
+#define GAME_NO_PORTAL_SLOT -1 /**< Portal slot of an object which is not a portal on the board */
+
+#include"snake.h"
+#include"vector2i.h"
+#include"game_object.h"
+#include"simulation_setup.h"
+#include"occupancy_grid.h"
+#include"game_random.h"
+
+/**
+ * @enum GAME_MODE
+ * @brief Different game modes available.
+ */
+typedef enum {
+    GAME_SINGLE_PLAYER_MODE = 1,   /**< Single-player mode. */
+    GAME_TWO_PLAYER_MODE = 2,      /**< Two-player mode. */
+    GAME_ARENA_MODE = 3            /**< Players and many bots, see init_arena_game(). */
+} GAME_MODE;
+
+/**
+ * @struct GameConfig
+ * @brief Holds game configuration and runtime state.
+ *
+ * ## Snakes
+ * The game has `snakes_count` snakes. The first `players_count` ones are
+ * driven by the players, the others are bots (see game_bot.h). The snake
+ * `i` has the id `i + 1` in the occupancy grid, so a collision between any
+ * two snakes is found with a single cell lookup, whatever their number.
+ *
+ * ## Memory
+ * Everything whose size depends on the grid or on the number of snakes
+ * (the occupancy grid arrays, the snakes and their ring buffers) lives in
+ * a single block, the arena, allocated by init_game() or init_arena_game()
+ * and released by free_game().
+ *
+ * ## Portals
+ * The object `i` has the id `i + 1` in the occupancy grid, so the object
+ * under a snake head is a single cell lookup. The portals on the board are
+ * also kept in the compact list `portals` (indices in `objects`, in no
+ * particular order), with `portal_slot[i]` the position of the object `i`
+ * in that list (GAME_NO_PORTAL_SLOT if it is not a portal on the board).
+ * The list is updated by place_game_object(), so choosing a destination
+ * never scans the objects which are not portals.
+ */
+typedef struct {
+    GameObject objects[GAME_OBJECTS_NUMBER]; /**< Active game objects */
+    int portals[GAME_OBJECTS_NUMBER];        /**< Indices in objects of the portals on the board */
+    int portal_slot[GAME_OBJECTS_NUMBER];    /**< Slot of each object in portals */
+    int portals_count;                       /**< Number of portals on the board */
+    OccupancyGrid grid;        /**< Cells covered by the snakes */
+    void *arena;               /**< Memory of the grid and of the snake buffers, NULL if none */
+
+    unsigned long move_timer;  /**< Snake movement interval in nanoseconds */
+    Snake *snakes;             /**< All the snakes, players first, then bots */
+    int snakes_count;          /**< Number of snakes */
+    int players_count;         /**< Number of snakes driven by a player */
+    GAME_MODE game_mode;       /**< Current game mode */
+    int force_exit;            /**< Exit game loop flag */
+    int board_full;            /**< Set when no free cell is left for an object: the game is won */
+    GameRandom random;         /**< Generator used by every random draw of the game */
+
+    unsigned int score;        /**< Current score */
+    unsigned long time;        /**< Global game time */
+} GameConfig;
+
+/**
+ * @brief Initializes the game configuration and sets up snakes and apple.
+ *
+ * Only the player modes (GAME_SINGLE_PLAYER_MODE and GAME_TWO_PLAYER_MODE)
+ * are started here, GAME_ARENA_MODE is started by init_arena_game().
+ *
+ * The game only draws random numbers from its own generator, seeded
+ * here: the same seed with the same inputs replays the same game.
+ *
+ * The game memory is allocated here and must be released with free_game().
+ *
+ * @param[out] game_config Pointer to the GameConfig structure to initialize.
+ * @param[in] game_mode **GAME_MODE** to start.
+ * @param[in] width Number of columns of the grid (MIN_GRID_SIZE to MAX_GRID_SIZE).
+ * @param[in] height Number of rows of the grid (MIN_GRID_SIZE to MAX_GRID_SIZE).
+ * @param[in] seed Seed of the game random generator.
+ * @return int 1 on success, 0 if the size is invalid or the allocation failed.
+ */
+int init_game(GameConfig *game_config, GAME_MODE game_mode, int width, int height, unsigned long seed);
+
+/**
+ * @brief Initializes an arena game: players and bots on the same grid.
+ *
+ * Every snake starts with one segment on a random free cell. A dead bot
+ * comes back on a random free cell on the next tick, the game ends when
+ * all the players are dead (never if there is no player).
+ *
+ * The game memory is allocated here and must be released with free_game().
+ *
+ * @param[out] game_config Pointer to the GameConfig structure to initialize.
+ * @param[in] players Number of snakes driven by players (0 to 2).
+ * @param[in] bots Number of bots.
+ * @param[in] width Number of columns of the grid (MIN_GRID_SIZE to MAX_GRID_SIZE).
+ * @param[in] height Number of rows of the grid (MIN_GRID_SIZE to MAX_GRID_SIZE).
+ * @param[in] seed Seed of the game random generator.
+ * @return int 1 on success, 0 if a parameter is invalid (at most GAME_MAX_SNAKES
+ *         snakes and one snake per 4 cells) or the allocation failed.
+ */
+int init_arena_game(GameConfig *game_config, int players, int bots,
+                    int width, int height, unsigned long seed);
+
+/**
+ * @brief Starts a new game in the arena of the current one.
+ *
+ * The new game has the mode, the grid size and the snakes of the current
+ * one and is the same game as a fresh init_game() or init_arena_game()
+ * with the same seed, without allocating its memory again.
+ *
+ * @param[in,out] game_config Pointer to a started game.
+ * @param[in] seed Seed of the game random generator.
+ * @return int 1 on success, 0 if the game has no arena.
+ */
+int restart_game(GameConfig *game_config, unsigned long seed);
+
+/**
+ * @brief Allocates the arena of a game and binds it to the grid and the snakes.
+ *
+ * The snakes array of game_config->snakes_count snakes is allocated and
+ * every snake gets its ring buffer (the snakes themselves are not reset),
+ * then the occupancy grid is initialized empty.
+ *
+ * A snake buffer holds one position per grid cell with up to two snakes.
+ * With more snakes the grid area is shared: each buffer holds
+ * 2 * width * height / snakes_count positions, and a snake that fills its
+ * buffer stops growing. SNAKE_ROLLBACK_SIZE more positions are added to
+ * every buffer (see move_and_expand_snake()).
+ *
+ * @param[in,out] game_config Pointer to the game configuration, snakes_count must be set.
+ * @param[in] width Number of columns of the grid.
+ * @param[in] height Number of rows of the grid.
+ * @return int 1 on success, 0 if the size is invalid or the allocation failed.
+ */
+int alloc_game_arena(GameConfig *game_config, int width, int height);
+
+/**
+ * @brief Releases the memory of a game.
+ *
+ * Does nothing if the game has no arena.
+ *
+ * @param[in,out] game_config Pointer to the game configuration.
+ */
+void free_game(GameConfig *game_config);
+
+/**
+ * @brief Rebuilds the occupancy grid from the current snakes.
+ *
+ * Clears the grid, attaches the snakes to it (snake i has id i + 1) and
+ * registers the game objects (object i has id i + 1). Must be called
+ * whenever the snakes are
+ * replaced as a whole, e.g. after loading a saved game.
+ *
+ * @param[in,out] game_config Pointer to the game configuration.
+ */
+void rebuild_occupancy_grid(GameConfig *game_config);
+
+/**
+ * @brief Places a game object at a random free position on the grid.
+ *
+ * The position is chosen so that it does not collide with any snake
+ * segment or existing game object. It is drawn once from the free cell
+ * set of the occupancy grid, so the call takes constant time.
+ *
+ * If the board has no free cell left, the object is removed from the
+ * board (its type becomes GAME_OBJECT_NONE). The list of the portals of
+ * the game follows the result.
+ *
+ * @param[in]  game_config Pointer to the current game configuration.
+ * @param[out] object      Game object of game_config->objects to place on the grid.
+ * @return int 1 if the object was placed, 0 if the board is full.
+ */
+int place_game_object(GameConfig *game_config, GameObject *object);
+
+/**
+ * @brief Repositions portal objects if no snake is currently inside them.
+ *
+ * Portals are moved to a new random free position when they are not
+ * occupied by any snake segment.
+ *
+ * @param[in,out] config Pointer to the current game configuration.
+ */
+void replace_portals(GameConfig *config);
+
+/**
+ * @brief Puts a dead snake back on the grid with one segment.
+ *
+ * The body of the snake is removed from the grid, then the snake restarts
+ * on a random free cell in a random direction. Nothing is done if the
+ * board has no free cell.
+ *
+ * @param[in,out] config Pointer to the current game configuration.
+ * @param[in,out] snake Snake of config->snakes to respawn.
+ * @return int 1 if the snake was respawned, 0 otherwise.
+ */
+int respawn_snake(GameConfig *config, Snake *snake);
+
+
+#endif /* _GAME_CONFIG_H */
\ No newline at end of file
@@ -1,6 +1,4 @@
-
 #include "vector2i.h"
-#include <MLV/MLV_image.h>
 
 /**
  * @brief Types of game objects.
@@ -15,11 +13,10 @@ typedef enum {
  * @brief Represents a game object.
  *
  * @details
- * Stores the object type, position, sprite, and color.
+ * Stores the object type and position. The sprite and color used to draw
+ * it live in the parallel GameObjectView.
  */
 typedef struct {
     GAME_OBJECT_TYPE type; /**< Type of the object. */
     vector2i pos;          /**< Position on the game grid. */
-    MLV_Image *sprite;     /**< Sprite image for rendering. */
-    MLV_Color color;       /**< Object color. */
-} GameObject;
\ No newline at end of file
+} GameObject;
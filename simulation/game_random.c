@@ -0,0 +1,62 @@
+#include"game_random.h"
+
+static uint32_t rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+static uint32_t splitmix32(uint32_t *x) {
+    uint32_t z;
+
+    *x += 0x9e3779b9u;
+    z = *x;
+    z = (z ^ (z >> 16)) * 0x85ebca6bu;
+    z = (z ^ (z >> 13)) * 0xc2b2ae35u;
+
+    return z ^ (z >> 16);
+}
+
+void seed_game_random(GameRandom *random, unsigned long seed) {
+    uint32_t x;
+    int i;
+
+    /* fold the high bits of a 64 bits seed */
+    x = (uint32_t) (seed ^ ((seed >> 16) >> 16));
+
+    for (i = 0; i < 4; i++)
+        random->state[i] = splitmix32(&x);
+
+    if ((random->state[0] | random->state[1] | random->state[2] | random->state[3]) == 0)
+        random->state[0] = 1;
+}
+
+uint32_t next_game_random(GameRandom *random) {
+    uint32_t *s, res, t;
+
+    s = random->state;
+
+    res = rotl(s[1] * 5, 7) * 9;
+    t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+
+    return res;
+}
+
+int game_random_range(GameRandom *random, int n) {
+    uint32_t bound, threshold, r;
+
+    bound = (uint32_t) n;
+    threshold = (0u - bound) % bound;
+
+    do {
+        r = next_game_random(random);
+    } while (r < threshold);
+
+    return (int) (r % bound);
+}
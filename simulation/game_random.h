@@ -0,0 +1,54 @@
+/**
+ * @file game_random.h
+ * @brief Small deterministic pseudo-random number generator.
+ *
+ * Every game owns its own generator state (xoshiro128**), so two games
+ * started with the same seed and receiving the same inputs play exactly
+ * the same way, and independent games can run in parallel threads
+ * without sharing any state (unlike the global rand()).
+ */
+
+#ifndef _GAME_RANDOM_H
+#define _GAME_RANDOM_H
+
+#include<stdint.h>
+
+/**
+ * @struct GameRandom
+ * @brief State of a xoshiro128** generator.
+ */
+typedef struct {
+    uint32_t state[4]; /**< Generator state, never all zero. */
+} GameRandom;
+
+/**
+ * @brief Initializes a generator from a seed.
+ *
+ * The seed is spread over the whole state with splitmix32, so close
+ * seeds still give unrelated sequences.
+ *
+ * @param[out] random Generator to initialize.
+ * @param[in] seed Any value, identical seeds give identical sequences.
+ */
+void seed_game_random(GameRandom *random, unsigned long seed);
+
+/**
+ * @brief Returns the next 32 bits random value.
+ *
+ * @param[in,out] random Generator.
+ * @return uint32_t Uniformly distributed value.
+ */
+uint32_t next_game_random(GameRandom *random);
+
+/**
+ * @brief Returns a random integer in [0, n).
+ *
+ * The result is unbiased (rejection of the incomplete last range).
+ *
+ * @param[in,out] random Generator.
+ * @param[in] n Upper bound, must be greater than 0.
+ * @return int Value between 0 and n - 1.
+ */
+int game_random_range(GameRandom *random, int n);
+
+#endif /* _GAME_RANDOM_H */
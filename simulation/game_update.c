@@ -0,0 +1,209 @@
+#include"game_update.h"
+#include"game_bot.h"
+
+void check_outofbounds(GameConfig *config, Snake *snake) {
+    vector2i head_p;
+    int width, height;
+    
+    head_p = *get_snake_head_position(snake);
+    width = config->grid.width;
+    height = config->grid.height;
+
+    if (head_p.x < 0)
+        head_p.x = width - 1;
+    else if (width <= head_p.x)
+        head_p.x = 0;
+
+    if (head_p.y < 0)
+        head_p.y = height - 1;
+    else if (height <= head_p.y)
+        head_p.y = 0;
+
+    set_snake_head_position(snake, head_p);
+}
+
+int check_apple_eat(GameConfig *config, Snake *snake) {
+    GameObject *object;
+    vector2i *head_p;
+    int res, i;
+
+    res = 0;
+
+    head_p = get_snake_head_position(snake);
+
+    for (i = 0; i < GAME_OBJECTS_NUMBER && res == 0; i++) {
+        object = &config->objects[i];
+
+        if (object->type == GAME_OBJECT_APPLE) {
+            res = head_p->x == object->pos.x && head_p->y == object->pos.y;
+        }
+    }
+    
+    if (res) {
+        if (!place_game_object(config, object))
+            config->board_full = 1;
+
+        /* bots neither score nor speed the game up */
+        if (snake - config->snakes < config->players_count) {
+            config->score += 10;
+
+            config->move_timer = config->move_timer * SPEED_UP;
+        }
+
+        if (game_random_range(&config->random, 100) <= PORTAL_REPLACE_CHANCE) {
+            replace_portals(config);
+        }
+    }
+
+    return res;
+}
+
+/*
+ * Returns 1 if the portal at the given slot of the portal list can be the
+ * destination of a snake entering the portal of index `entry`.
+ */
+static int is_open_portal(GameConfig *config, int slot, int entry) {
+    GameObject *portal;
+
+    portal = &config->objects[config->portals[slot]];
+
+    /* a portal covered by any snake is closed */
+    return config->portals[slot] != entry &&
+           get_cell_owner(&config->grid, portal->pos) == OCCUPANCY_NO_OWNER;
+}
+
+GameObject* check_portal_colision(Snake *snake, GameConfig *config) {
+    GameObject *end_portal;
+    unsigned short object_id;
+    int i, entry, candidates, random_p;
+
+    end_portal = NULL;
+    object_id = get_cell_object(&config->grid, *get_snake_head_position(snake));
+
+    if (object_id != OCCUPANCY_NO_OBJECT &&
+        config->objects[object_id - 1].type == GAME_OBJECT_PORTAL) {
+        entry = object_id - 1;
+
+        candidates = 0;
+        for (i = 0; i < config->portals_count; i++)
+            candidates += is_open_portal(config, i, entry);
+
+        if (candidates > 0) {
+            random_p = game_random_range(&config->random, candidates);
+
+            for (i = 0; end_portal == NULL; i++) {
+                if (is_open_portal(config, i, entry)) {
+                    if (random_p == 0)
+                        end_portal = &config->objects[config->portals[i]];
+                    else
+                        random_p--;
+                }
+            }
+        }
+    }
+
+    return end_portal;
+}
+
+void check_self_snake_colision(Snake *snake) {
+    vector2i *head_p, *tmp_p; 
+    size_t i;
+
+    head_p = get_snake_head_position(snake);
+
+    if (snake->grid != NULL) {
+        /* the head is registered in its cell unless another segment was there */
+        if (find_snake_part_by_position(snake, *head_p) >= SNAKE_SELF_COLISION_START)
+            snake->is_alive = 0;
+    } else {
+        for (i = SNAKE_SELF_COLISION_START; i < get_snake_size(snake) && snake->is_alive; i++) {
+            tmp_p = get_snake_part_position(snake, i);
+
+            if (head_p->x == tmp_p->x && head_p->y == tmp_p->y)
+                snake->is_alive = 0;
+        }
+    }
+}
+
+void check_snake_colision(Snake *first, Snake *second) {
+    vector2i *head_p, *tmp_p; 
+    size_t i;
+
+    head_p = get_snake_head_position(first);
+
+    if (first->grid != NULL && first->grid == second->grid) {
+        if (get_cell_owner(first->grid, *head_p) == second->grid_id)
+            first->is_alive = 0;
+    } else {
+        for (i = 0; i < get_snake_size(second) && first->is_alive; i++) {
+            tmp_p = get_snake_part_position(second, i);
+
+            if (head_p->x == tmp_p->x && head_p->y == tmp_p->y)
+                first->is_alive = 0;
+        }
+    }
+    
+}
+
+void check_snakes_colision(GameConfig *config, Snake *snake) {
+    unsigned short owner;
+
+    /* the head is registered in its cell unless a segment was already there */
+    owner = get_cell_owner(&config->grid, *get_snake_head_position(snake));
+
+    if (owner != OCCUPANCY_NO_OWNER && owner != snake->grid_id)
+        snake->is_alive = 0;
+}
+
+void update_snake(GameConfig *config, Snake *snake) {
+    GameObject *portal_move;
+    
+    if (snake->is_alive) {
+        apply_snake_turn(snake);
+        portal_move = check_portal_colision(snake, config);
+
+        if (check_apple_eat(config, snake))
+            move_and_expand_snake(snake);
+        else
+            move_snake(snake);
+
+        if (portal_move != NULL) {
+            set_snake_head_position(snake, portal_move->pos);
+            move_snake(snake);
+        }
+        
+
+        check_outofbounds(config, snake);
+        check_self_snake_colision(snake);
+
+        if (snake->is_alive)
+            check_snakes_colision(config, snake);
+
+        if (!snake->is_alive) {
+            move_back_snake(snake);
+            if (get_snake_size(snake) > 1)
+                remove_tail_snake(snake);
+
+            if (portal_move != NULL)
+                move_back_snake(snake);
+        }
+    }
+}
+
+void update_game(GameConfig *config) {
+    Snake *snake;
+    int i;
+
+    for (i = 0; i < config->snakes_count; i++) {
+        snake = config->snakes + i;
+
+        if (i >= config->players_count) {
+            if (snake->is_alive)
+                update_bot(config, snake);
+            else
+                respawn_snake(config, snake);
+        }
+
+        update_snake(config, snake);
+    }
+}
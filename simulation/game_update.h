@@ -0,0 +1,112 @@
+/**
+ * @file game_update.h
+ * @brief Simulation tick of the Snake game.
+ *
+ * This file defines the rules applied at every game tick: snake movement,
+ * wrapping around the grid, apple consumption, portals and collisions.
+ * It only works on the plain GameConfig data and does not depend on MLV,
+ * so it can run without any window.
+ */
+#ifndef _GAME_UPDATE_H
+#define _GAME_UPDATE_H
+
+#include<stdlib.h>
+#include"game_config.h"
+
+#define SPEED_UP 498 / 500                      /**< Speed multiplier when apple is eaten */
+
+/**
+ * @brief Wraps the snake around the grid if it goes out of bounds.
+ *
+ * @param[in] config Pointer to the game configuration (grid size).
+ * @param[in,out] snake Pointer to the snake.
+ */
+void check_outofbounds(GameConfig *config, Snake* snake);
+
+/**
+ * @brief Checks if the snake has eaten the apple.
+ *
+ * @param[in,out] config Pointer to the game configuration.
+ * @param[in,out] snake Pointer to the snake.
+ * @return int Returns 1 if apple was eaten, 0 otherwise.
+ *
+ * @details
+ * If the apple is eaten, it is relocated to a new random position
+ * and the snake's movement timer is adjusted (speed up).
+ * When no free cell is left for the apple, config->board_full is set.
+ */
+int check_apple_eat(GameConfig *config, Snake* snake);
+
+/**
+ * @brief Checks if the snake has collided with a portal.
+ *
+ * @param[in] snake Pointer to the snake.
+ * @param[in] config Pointer to the game configuration.
+ * @return GameObject* Returns a pointer to the destination portal if a collision occurs, NULL otherwise.
+ *
+ * @details
+ * The function detects if the snake's head is on a portal (one lookup in
+ * the occupancy grid). If so, it draws the destination once among the
+ * other portals of config->portals which are not covered by a snake, so
+ * the snake never teleports into itself or into another snake. NULL is
+ * returned if no portal is open.
+ */
+GameObject* check_portal_colision(Snake *snake, GameConfig *config);
+
+/**
+ * @brief Checks if the snake collided with itself.
+ *
+ * @param[in,out] snake Pointer to the snake.
+ *
+ * @details
+ * Sets snake->is_alive to 0 if the head intersects with any part of its body.
+ */
+void check_self_snake_colision(Snake *snake);
+
+/**
+ * @brief Checks if one snake collides with another snake.
+ *
+ * @param[in,out] first Pointer to the first snake.
+ * @param[in] second Pointer to the second snake.
+ *
+ * @details
+ * Sets first->is_alive to 0 if its head collides with any part of the second snake.
+ */
+void check_snake_colision(Snake *first, Snake *second);
+
+/**
+ * @brief Checks if the head of a snake collides with any other snake of the game.
+ *
+ * @param[in] config Pointer to the game configuration.
+ * @param[in,out] snake Pointer to a snake of config->snakes.
+ *
+ * @details
+ * Sets snake->is_alive to 0 if the head cell is covered by another snake.
+ * This is a single lookup in the occupancy grid, whatever the number of
+ * snakes.
+ */
+void check_snakes_colision(GameConfig *config, Snake *snake);
+
+/**
+ * @brief Updates a single snake's state for one game tick.
+ *
+ * The next queued turn of the snake (see queue_snake_turn()) is applied
+ * first, once per tick, even if the snake goes through a portal.
+ *
+ * @param[in,out] config Pointer to the game configuration.
+ * @param[in,out] snake Pointer to the snake being updated, one of config->snakes.
+ */
+void update_snake(GameConfig *config, Snake *snake);
+
+/**
+ * @brief Updates the state of the entire game for one tick.
+ *
+ * @param[in,out] config Pointer to the game configuration.
+ *
+ * @details
+ * Calls update_snake for all the snakes, in order. The bots choose their
+ * direction just before moving, and a dead bot is respawned instead.
+ */
+void update_game(GameConfig *config);
+
+#endif /* _GAME_UPDATE_H */
@@ -0,0 +1,119 @@
+#include"occupancy_grid.h"
+
+/*
+ * Adds or removes a cell from the free cell set so that it matches
+ * the content of the cell.
+ */
+static void update_free_cell(OccupancyGrid *grid, int index) {
+    OccupancyCell *cell;
+    int slot, last;
+
+    cell = &grid->cells[index];
+    slot = grid->free_slot[index];
+
+    if (cell->owner == OCCUPANCY_NO_OWNER && cell->object == OCCUPANCY_NO_OBJECT) {
+        if (slot == OCCUPANCY_NOT_FREE) {
+            grid->free_cells[grid->free_count] = index;
+            grid->free_slot[index] = grid->free_count;
+            grid->free_count++;
+        }
+    } else if (slot != OCCUPANCY_NOT_FREE) {
+        /* swap-remove: the last free cell takes the removed slot */
+        grid->free_count--;
+        last = grid->free_cells[grid->free_count];
+
+        grid->free_cells[slot] = last;
+        grid->free_slot[last] = slot;
+        grid->free_slot[index] = OCCUPANCY_NOT_FREE;
+    }
+}
+
+void init_occupancy_grid(OccupancyGrid *grid, int width, int height,
+                         OccupancyCell *cells, int *free_cells, int *free_slot) {
+    grid->width = width;
+    grid->height = height;
+    grid->cells = cells;
+    grid->free_cells = free_cells;
+    grid->free_slot = free_slot;
+
+    clear_occupancy_grid(grid);
+}
+
+void clear_occupancy_grid(OccupancyGrid *grid) {
+    int i, size;
+
+    size = grid->width * grid->height;
+
+    for (i = 0; i < size; i++) {
+        grid->cells[i].owner = OCCUPANCY_NO_OWNER;
+        grid->cells[i].stamp = 0;
+        grid->cells[i].object = OCCUPANCY_NO_OBJECT;
+
+        grid->free_cells[i] = i;
+        grid->free_slot[i] = i;
+    }
+
+    grid->free_count = size;
+}
+
+int is_in_grid(OccupancyGrid *grid, vector2i pos) {
+    return 0 <= pos.x && pos.x < grid->width &&
+           0 <= pos.y && pos.y < grid->height;
+}
+
+OccupancyCell* get_occupancy_cell(OccupancyGrid *grid, vector2i pos) {
+    OccupancyCell *res;
+
+    if (grid == NULL || !is_in_grid(grid, pos))
+        res = NULL;
+    else
+        res = &grid->cells[pos.y * grid->width + pos.x];
+
+    return res;
+}
+
+unsigned short get_cell_owner(OccupancyGrid *grid, vector2i pos) {
+    OccupancyCell *cell;
+
+    cell = get_occupancy_cell(grid, pos);
+
+    return cell == NULL ? OCCUPANCY_NO_OWNER : cell->owner;
+}
+
+unsigned short get_cell_object(OccupancyGrid *grid, vector2i pos) {
+    OccupancyCell *cell;
+
+    cell = get_occupancy_cell(grid, pos);
+
+    return cell == NULL ? OCCUPANCY_NO_OBJECT : cell->object;
+}
+
+void set_cell_owner(OccupancyGrid *grid, OccupancyCell *cell, unsigned short owner, unsigned long stamp) {
+    cell->owner = owner;
+    cell->stamp = stamp;
+
+    update_free_cell(grid, (int) (cell - grid->cells));
+}
+
+void set_cell_object(OccupancyGrid *grid, vector2i pos, unsigned short object) {
+    OccupancyCell *cell;
+
+    cell = get_occupancy_cell(grid, pos);
+
+    if (cell != NULL) {
+        cell->object = object;
+        update_free_cell(grid, (int) (cell - grid->cells));
+    }
+}
+
+int get_free_cell_count(OccupancyGrid *grid) {
+    return grid->free_count;
+}
+
+vector2i get_free_cell(OccupancyGrid *grid, int slot) {
+    int index;
+
+    index = grid->free_cells[slot];
+
+    return create_vector2i(index % grid->width, index / grid->width);
+}
@@ -0,0 +1,168 @@
+/**
+ * @file occupancy_grid.h
+ * @brief Per-cell occupancy map of the game grid.
+ *
+ * The occupancy grid stores, for every cell of the board, which snake
+ * covers it and which segment of that snake it is. It is kept up to date
+ * incrementally by the snake movement functions so that collision tests
+ * and "is this cell free" queries are a single array lookup, whatever
+ * the length of the snakes.
+ *
+ * It also keeps the set of free cells (covered neither by a snake nor by a
+ * game object), so that a random free cell can be picked in constant time.
+ */
+
+#ifndef _OCCUPANCY_GRID_H
+#define _OCCUPANCY_GRID_H
+
+#include<stdlib.h>
+
+#include"simulation_setup.h"
+#include"vector2i.h"
+
+#define OCCUPANCY_NO_OWNER 0  /**< Owner id of a cell not covered by any snake */
+#define OCCUPANCY_NO_OBJECT 0 /**< Object id of a cell without game object */
+#define OCCUPANCY_NOT_FREE -1 /**< Free slot of a cell which is not free */
+
+/**
+ * @struct OccupancyCell
+ * @brief State of one cell of the occupancy grid.
+ *
+ * ## Segment age
+ * Every snake counts its moves. When a segment is written in a cell, the
+ * current move counter of the snake is stored in `stamp`. The index of the
+ * segment inside the snake (0 = head) is then simply:
+ *
+ *     index = snake->moves - cell->stamp
+ *
+ * so the segment "ages" by one each time the snake moves, without the cell
+ * ever being rewritten.
+ */
+typedef struct {
+    unsigned long stamp;   /**< Move counter of the owner when the segment was written. */
+    unsigned short owner;  /**< Grid id of the snake covering the cell, OCCUPANCY_NO_OWNER if free. */
+    unsigned short object; /**< Id of the game object on the cell, OCCUPANCY_NO_OBJECT if none. */
+} OccupancyCell;
+
+/**
+ * @struct OccupancyGrid
+ * @brief Occupancy state of the whole game grid.
+ *
+ * ## Free cell set
+ * `free_cells[0 .. free_count - 1]` holds the indices of all free cells in
+ * no particular order, and `free_slot[i]` is the position of cell `i` in
+ * that array (OCCUPANCY_NOT_FREE if the cell is covered). Adding a cell
+ * appends it, removing a cell moves the last entry into its slot, so both
+ * operations are O(1).
+ *
+ * ## Memory
+ * The grid does not allocate anything: its three arrays of
+ * `width * height` entries are given to init_occupancy_grid() by the
+ * owner of the grid (the game arena, see init_game()).
+ */
+typedef struct {
+    int width;                 /**< Number of columns. */
+    int height;                /**< Number of rows. */
+    OccupancyCell *cells;      /**< Cells stored row by row. */
+    int *free_cells;           /**< Dense array of free cell indices. */
+    int *free_slot;            /**< Slot of each cell in free_cells. */
+    int free_count;            /**< Number of free cells. */
+} OccupancyGrid;
+
+/**
+ * @brief Sets the size and the memory of a grid, then clears it.
+ *
+ * @param[out] grid Pointer to the grid.
+ * @param[in] width Number of columns.
+ * @param[in] height Number of rows.
+ * @param[in] cells Array of width * height cells.
+ * @param[in] free_cells Array of width * height integers.
+ * @param[in] free_slot Array of width * height integers.
+ */
+void init_occupancy_grid(OccupancyGrid *grid, int width, int height,
+                         OccupancyCell *cells, int *free_cells, int *free_slot);
+
+/**
+ * @brief Marks every cell of the grid as free, without snake nor object.
+ *
+ * @param[out] grid Pointer to the grid.
+ */
+void clear_occupancy_grid(OccupancyGrid *grid);
+
+/**
+ * @brief Checks if a position is inside the game grid.
+ *
+ * @param[in] grid Pointer to the grid.
+ * @param[in] pos Position to test.
+ * @return int 1 if the position is inside the grid, 0 otherwise.
+ */
+int is_in_grid(OccupancyGrid *grid, vector2i pos);
+
+/**
+ * @brief Returns the cell at a given position.
+ *
+ * @param[in] grid Pointer to the grid.
+ * @param[in] pos Position of the cell.
+ * @return OccupancyCell* Pointer to the cell, NULL if pos is outside the grid.
+ */
+OccupancyCell* get_occupancy_cell(OccupancyGrid *grid, vector2i pos);
+
+/**
+ * @brief Returns the id of the snake covering a position.
+ *
+ * @param[in] grid Pointer to the grid.
+ * @param[in] pos Position of the cell.
+ * @return unsigned short Owner id, OCCUPANCY_NO_OWNER if the cell is free
+ *         or outside the grid.
+ */
+unsigned short get_cell_owner(OccupancyGrid *grid, vector2i pos);
+
+/**
+ * @brief Returns the id of the game object lying on a position.
+ *
+ * @param[in] grid Pointer to the grid.
+ * @param[in] pos Position of the cell.
+ * @return unsigned short Object id, OCCUPANCY_NO_OBJECT if the cell has
+ *         no object or is outside the grid.
+ */
+unsigned short get_cell_object(OccupancyGrid *grid, vector2i pos);
+
+/**
+ * @brief Changes the snake covering a cell.
+ *
+ * @param[in,out] grid Pointer to the grid.
+ * @param[in,out] cell Cell of the grid to modify.
+ * @param[in] owner New owner id (OCCUPANCY_NO_OWNER to free the cell).
+ * @param[in] stamp Move counter of the owner (ignored when freeing).
+ */
+void set_cell_owner(OccupancyGrid *grid, OccupancyCell *cell, unsigned short owner, unsigned long stamp);
+
+/**
+ * @brief Changes the game object lying on a position.
+ *
+ * Nothing is done if pos is outside the grid.
+ *
+ * @param[in,out] grid Pointer to the grid.
+ * @param[in] pos Position of the cell.
+ * @param[in] object New object id (OCCUPANCY_NO_OBJECT to remove it).
+ */
+void set_cell_object(OccupancyGrid *grid, vector2i pos, unsigned short object);
+
+/**
+ * @brief Returns the number of free cells.
+ *
+ * @param[in] grid Pointer to the grid.
+ * @return int Number of cells covered neither by a snake nor by an object.
+ */
+int get_free_cell_count(OccupancyGrid *grid);
+
+/**
+ * @brief Returns the position of a free cell.
+ *
+ * @param[in] grid Pointer to the grid.
+ * @param[in] slot Index in the free cell set, between 0 and get_free_cell_count() - 1.
+ * @return vector2i Position of the free cell.
+ */
+vector2i get_free_cell(OccupancyGrid *grid, int slot);
+
+#endif /* _OCCUPANCY_GRID_H */
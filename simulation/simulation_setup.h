@@ -0,0 +1,11 @@
+#define GRID_SIZE 20 /**< Default number of cells in one dimension of the grid */
+#define MIN_GRID_SIZE 8 /**< Smallest grid width or height accepted by init_game */
+#define MAX_GRID_SIZE 4096 /**< Largest grid width or height accepted by init_game */
+
+#define MOVE_TIME ( 230LU * 1000000LU ) /**< Default snake movement interval in nanoseconds */
+
+#define PORTAL_REPLACE_CHANCE 30  /**< Chance (0–100) to replace a portal with another object */
+
+#if (PORTAL_REPLACE_CHANCE < 0 || PORTAL_REPLACE_CHANCE > 100)
+#error "PORTAL_REPLACE_CHANCE must to be beetwen 0 AND 100"
+#endif
@@ -0,0 +1,302 @@
+#include"snake.h"
+
+/*
+ * Registers the segment `index` of the snake in its occupancy grid.
+ * A free cell is always claimed. A cell covered by one of the few segments
+ * right behind the head is taken over (this overlap is not a collision),
+ * any other covered cell is left untouched.
+ */
+static void claim_snake_cell(Snake *snake, size_t index) {
+    OccupancyCell *cell;
+    unsigned long stamp;
+
+    if (snake->grid != NULL) {
+        cell = get_occupancy_cell(snake->grid, *get_snake_part_position(snake, index));
+        stamp = snake->moves - index;
+
+        if (cell != NULL &&
+            (cell->owner == OCCUPANCY_NO_OWNER ||
+             (cell->owner == snake->grid_id &&
+              cell->stamp < stamp &&
+              snake->moves - cell->stamp < SNAKE_SELF_COLISION_START))) {
+            set_cell_owner(snake->grid, cell, snake->grid_id, stamp);
+        }
+    }
+}
+
+/*
+ * Frees the cell of segment `index` if it is really registered for it.
+ */
+static void release_snake_cell(Snake *snake, size_t index) {
+    OccupancyCell *cell;
+
+    if (snake->grid != NULL) {
+        cell = get_occupancy_cell(snake->grid, *get_snake_part_position(snake, index));
+
+        if (cell != NULL &&
+            cell->owner == snake->grid_id &&
+            cell->stamp == snake->moves - index) {
+            set_cell_owner(snake->grid, cell, OCCUPANCY_NO_OWNER, 0);
+        }
+    }
+}
+
+Snake create_snake(vector2i *items, size_t capacity) {
+    Snake rep;
+
+    rep.items = items;
+    rep.capacity = capacity;
+
+    rep.items[0].x = 0;
+    rep.items[0].y = 2;
+        
+    rep.count = 1;
+    rep.head_index = 0;
+    rep.back_buffer = 0;
+    rep.is_alive = 1;
+
+    rep.grid = NULL;
+    rep.grid_id = OCCUPANCY_NO_OWNER;
+    rep.moves = 0;
+
+    rep.direction = SNAKE_DIRECTION_RIGTH;
+    rep.to_rotate = SNAKE_DIRECTION_RIGTH;
+
+    rep.turns_start = 0;
+    rep.turns_count = 0;
+    rep.turn_applied = 0;
+    rep.turn_time = 0;
+
+    return rep;
+}
+
+size_t get_snake_size(Snake *snake) {
+    return snake->count;
+}
+
+SnakeDirection get_snake_direction(Snake *snake) {
+    return snake->direction;
+}
+
+SnakeDirection get_snake_next_rotation(Snake *snake) {
+    return snake->to_rotate;
+}
+
+vector2i* get_snake_part_position(Snake *snake, size_t index) {
+    size_t real_index;
+
+    if (snake->count <= index) {
+        fprintf(stderr, "Error get_snake_part_position: Snake part position out of bounds");
+        exit(EXIT_FAILURE);
+    }
+    
+    real_index = (index + snake->head_index) % snake->capacity;
+
+    return &snake->items[real_index];
+}
+
+int find_snake_part_by_position(Snake *snake, vector2i pos) {
+    OccupancyCell *cell;
+    size_t i;
+    int res;
+
+    res = -1;
+
+    if (snake->grid != NULL) {
+        cell = get_occupancy_cell(snake->grid, pos);
+
+        if (cell != NULL && cell->owner == snake->grid_id &&
+            snake->moves - cell->stamp < snake->count)
+            res = (int) (snake->moves - cell->stamp);
+    } else {
+        for (i = 0; i < snake->count && res == -1; i++) {
+            if (get_snake_part_position(snake, i)->x == pos.x &&
+                get_snake_part_position(snake, i)->y == pos.y) {
+                    res = (int) i;
+                }
+        }
+    }
+
+    return res;
+}
+
+vector2i* get_snake_head_position(Snake *snake) {
+    return &snake->items[snake->head_index];
+}
+
+void set_snake_head_position(Snake *snake, vector2i pos) {
+    release_snake_cell(snake, 0);
+    snake->items[snake->head_index] = pos;
+    claim_snake_cell(snake, 0);
+}
+
+void attach_snake_to_grid(Snake *snake, OccupancyGrid *grid, unsigned short id) {
+    size_t i;
+
+    snake->grid = grid;
+    snake->grid_id = id;
+
+    /* from tail to head, so the newest segment wins an overlapping cell */
+    for (i = snake->count; i > 0; i--)
+        claim_snake_cell(snake, i - 1);
+}
+
+void detach_snake_from_grid(Snake *snake) {
+    size_t i;
+
+    for (i = 0; i < snake->count; i++)
+        release_snake_cell(snake, i);
+
+    snake->grid = NULL;
+    snake->grid_id = OCCUPANCY_NO_OWNER;
+}
+
+void update_snake_back_buffer(Snake *snake) {
+    size_t max_buffer;
+
+    max_buffer = snake->capacity - snake->count;
+    
+    if (snake->back_buffer > max_buffer)
+        snake->back_buffer = max_buffer;
+}
+
+/*
+ * Shared implementation of move_snake and move_and_expand_snake.
+ * The tail cell is released before the head moves, so the head may enter
+ * the cell the tail has just left.
+ */
+static void step_snake(Snake *snake, int expand) {
+    vector2i next_snake_p;
+    size_t next_head_i;
+    
+    next_snake_p = snake->items[snake->head_index];
+    
+    snake->direction = snake->to_rotate;
+
+    /* keep room behind the tail to undo the moves of the tick */
+    if (snake->count + SNAKE_ROLLBACK_SIZE >= snake->capacity)
+        expand = 0;
+
+    switch (snake->to_rotate) {
+    case SNAKE_DIRECTION_TOP:
+        next_snake_p.y -= 1;
+        break;
+    case SNAKE_DIRECTION_BOTTOM:
+        next_snake_p.y += 1;
+        break;
+    case SNAKE_DIRECTION_LEFT:
+        next_snake_p.x -= 1;
+        break;
+    case SNAKE_DIRECTION_RIGTH:
+        next_snake_p.x += 1;
+        break;
+    default:
+        break;
+    }
+
+    if (!expand)
+        release_snake_cell(snake, snake->count - 1);
+    
+    if (snake->head_index == 0)
+        next_head_i = snake->capacity - 1;
+    else
+        next_head_i = snake->head_index - 1;
+
+    snake->items[next_head_i] = next_snake_p;
+    snake->head_index = next_head_i;
+    snake->moves++;
+    
+    snake->back_buffer++;
+    update_snake_back_buffer(snake);
+
+    if (expand)
+        snake->count++;
+
+    claim_snake_cell(snake, 0);
+}
+
+void move_snake(Snake *snake) {
+    step_snake(snake, 0);
+}
+
+void move_back_snake(Snake *snake) {
+    if (snake->back_buffer > 0) {
+        release_snake_cell(snake, 0);
+
+        if (snake->head_index == snake->capacity - 1)
+            snake->head_index = 0;
+        else
+            snake->head_index++;
+        snake->moves--;
+        snake->back_buffer--;
+
+        /* the segment behind the tail is part of the snake again */
+        claim_snake_cell(snake, snake->count - 1);
+    }
+}
+
+void move_and_expand_snake(Snake *snake) {
+    step_snake(snake, 1);
+}
+
+void remove_tail_snake(Snake *snake) {
+
+    if (snake->count == 1) {
+        fprintf(stderr, "Error remove_tail_snake: snake is to small to remove tail");
+        exit(EXIT_FAILURE);
+    }
+    
+    release_snake_cell(snake, snake->count - 1);
+    snake->count--;
+    snake->back_buffer++;
+}
+
+void set_snake_direction(Snake *snake, SnakeDirection direction) {
+    if (snake->direction != -direction)
+        snake->to_rotate = direction;
+}
+
+int queue_snake_turn(Snake *snake, SnakeDirection direction, unsigned long time) {
+    SnakeDirection last;
+    SnakeTurn *turn;
+    int res;
+
+    if (snake->turns_count == 0)
+        last = snake->to_rotate;
+    else
+        last = snake->turns[(snake->turns_start + snake->turns_count - 1) % SNAKE_TURN_QUEUE_SIZE].direction;
+
+    res = snake->turns_count < SNAKE_TURN_QUEUE_SIZE &&
+          direction != last && direction != -last &&
+          (snake->turns_count > 0 || direction != -snake->direction);
+
+    if (res) {
+        turn = &snake->turns[(snake->turns_start + snake->turns_count) % SNAKE_TURN_QUEUE_SIZE];
+        turn->direction = direction;
+        turn->time = time;
+        snake->turns_count++;
+    }
+
+    return res;
+}
+
+int apply_snake_turn(Snake *snake) {
+    SnakeTurn *turn;
+
+    snake->turn_applied = 0;
+
+    while (snake->turns_count > 0 && !snake->turn_applied) {
+        turn = &snake->turns[snake->turns_start];
+
+        snake->turns_start = (snake->turns_start + 1) % SNAKE_TURN_QUEUE_SIZE;
+        snake->turns_count--;
+
+        if (turn->direction != -snake->direction) {
+            snake->to_rotate = turn->direction;
+            snake->turn_time = turn->time;
+            snake->turn_applied = 1;
+        }
+    }
+
+    return snake->turn_applied;
+}
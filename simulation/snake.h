@@ -5,21 +5,25 @@
  * This file contains the data structures and functions used to create, move,
  * grow, and manage the snake entity. It handles position updates, direction changes,
  * buffer management, and access to snake body segments.
+ *
+ * The snake only holds plain simulation data. Everything needed to draw it
+ * (sprites, color) lives in the parallel SnakeView of the game front-end.
  */
 
+#ifndef _SNAKE_H
+#define _SNAKE_H
+
 #include<stdlib.h>
 #include<stdio.h>
 #include<string.h>
 
-#include"MLV/MLV_color.h"
-#include"MLV/MLV_image.h"
-#include"game_setup.h"
+#include"simulation_setup.h"
 #include"vector2i.h"
+#include"occupancy_grid.h"
 
-#define MAX_SNAKE_SIZE 900
-#define MAX_SNAKE_SPRITE_INDEX 21
-#define SNAKE_SPRITE_BASE_PATH "ressources/snake/snake000.png"
-#define SNAKE_SPRITE_NUMBER_INDEX 24
+#define SNAKE_SELF_COLISION_START 4 /**< First segment index the head can collide with */
+#define SNAKE_ROLLBACK_SIZE 2 /**< Buffer positions kept behind the tail so that a tick can be undone */
+#define SNAKE_TURN_QUEUE_SIZE 3 /**< Maximum number of turns waiting to be applied */
 
 /**
  * @enum SnakeDirection
@@ -33,19 +37,13 @@ typedef enum {
 } SnakeDirection;
 
 /**
- * @struct SnakeSprite
- * @brief Holds all sprite images used for rendering the snake.
- *
- * This structure groups together the different image assets required
- * to draw the snake, including the head, tail, straight body segments,
- * and curved body segments used during turns.
+ * @struct SnakeTurn
+ * @brief Direction change requested by a player, waiting for its move.
  */
 typedef struct {
-    MLV_Image *head;          /**< Image of the snake's head. */
-    MLV_Image *tail;          /**< Image of the snake's tail. */
-    MLV_Image *straight_body; /**< Image used for straight body segments. */
-    MLV_Image *rotate_body;   /**< Image used for curved/turn body segments. */
-} SnakeSprite;
+    SnakeDirection direction;  /**< Requested direction. */
+    unsigned long time;        /**< Time of the request, in the unit of the caller. */
+} SnakeTurn;
 
 /**
  * @struct Snake
@@ -54,14 +52,14 @@ typedef struct {
  * The snake is represented as a circular buffer storing body segment positions.
  * 
  * ## Principle of Operation
- * The snake's body segments are stored in a circular buffer `items` with a fixed
- * maximum size `MAX_SNAKE_SIZE`. The `head_index` points to the current head of
+ * The snake's body segments are stored in a circular buffer `items` of
+ * `capacity` positions. The `head_index` points to the current head of
  * the snake, and `count` represents the number of segments currently in the snake.
  * 
  * The `back_buffer` stores the number of previous positions behind the tail that
  * are still kept in memory. This allows the snake to "retrace" its movement if
  * needed (for example, for movement reversal). As the snake moves forward,
- * `back_buffer` increases but cannot exceed `MAX_SNAKE_SIZE - count`.
+ * `back_buffer` increases but cannot exceed `capacity - count`.
  * 
  * Each time the snake moves, the head moves forward in the buffer (incrementing
  * `head_index`). If the head reaches the end of the buffer, it wraps around
@@ -69,7 +67,7 @@ typedef struct {
  * without exceeding the fixed buffer size.
  * 
  * ### Visual representation of circular buffer
- * Suppose MAX_SNAKE_SIZE = 8, count = 5, back_buffer = 2:
+ * Suppose capacity = 8, count = 5, back_buffer = 2:
  * 
  *     Index:   0 1 2 3 4 5 6 7
  *     Buffer:  S T O O . H S S
@@ -89,43 +87,56 @@ typedef struct {
  * 2->3 positions behind the tail that still exist in memory (not yet overwritten).
  * The head moves forward each step and wraps around to index 0 when it reaches
  * the end of the buffer.
+ *
+ * ## Buffer memory
+ * The buffer is not owned by the snake: it is given to create_snake() by the
+ * caller. A game snake gets one position per grid cell from the game arena
+ * (see init_game()), a decorative snake only needs a few positions.
+ *
+ * ## Occupancy grid
+ * A snake can be attached to an OccupancyGrid with attach_snake_to_grid().
+ * From then on every function that changes the body (move_snake,
+ * move_and_expand_snake, move_back_snake, remove_tail_snake and
+ * set_snake_head_position) also updates the cells it enters or leaves.
+ * `moves` is the counter used to stamp the cells (see OccupancyCell).
+ * A cell already covered by another segment is never overwritten: the head
+ * then stays unregistered, which is exactly what the collision checks detect.
+ *
+ * ## Turn queue
+ * `to_rotate` only holds one pending direction. Players instead push their
+ * turns in the small queue `turns` with queue_snake_turn(), and every game
+ * tick applies one of them with apply_snake_turn(). Two quick key presses
+ * between two moves are then both played, on two consecutive moves.
  */
 typedef struct {
 
-    vector2i items[MAX_SNAKE_SIZE];        /**< Circular buffer of snake body segment positions. */
+    vector2i *items;                       /**< Circular buffer of snake body segment positions. */
+    size_t capacity;                       /**< Number of positions of the buffer, maximum snake size. */
     size_t count;                          /**< Current number of snake segments. */
     size_t head_index;                     /**< Index of the head within the buffer. */
     size_t back_buffer;                    /**< Free space behind the tail used for movement/growth. */
     SnakeDirection direction;              /**< Current direction of movement. */
     SnakeDirection to_rotate;              /**< Next direction change requested by user input. */
+    SnakeTurn turns[SNAKE_TURN_QUEUE_SIZE]; /**< Circular queue of turns waiting for a move. */
+    size_t turns_start;                    /**< Index of the oldest queued turn. */
+    size_t turns_count;                    /**< Number of queued turns. */
+    int turn_applied;                      /**< 1 if the last apply_snake_turn() applied a turn. */
+    unsigned long turn_time;               /**< Request time of the last applied turn. */
     int is_alive;                          /**< Boolean flag indicating if the snake is alive. */
-    
-    MLV_Color color;                       /**< Color used to render the snake. */
-    SnakeSprite sprite;
-    int sprite_index;
-} Snake;
 
-/**
- * @brief Loads and initializes all snake sprite sub-images.
- *
- * This function loads a full sprite sheet from the given file path,
- * extracts the individual images (head, straight body, rotated body, tail).
- *
- * If the SnakeSprite already contains images, they are safely freed
- * before loading the new ones.
- *
- * @param[in,out] sprite Pointer to the SnakeSprite structure to modify.
- *                       Existing images inside will be freed and replaced.
- * @param[in]     index  Index of sprite file to load.
- */
-void load_snake_sprite(Snake* snake, int index);
+    OccupancyGrid *grid;                   /**< Occupancy grid kept up to date by the snake, NULL if none. */
+    unsigned short grid_id;                /**< Owner id of the snake in the occupancy grid. */
+    unsigned long moves;                   /**< Number of moves done, used to stamp grid cells. */
+} Snake;
 
 /**
- * @brief Initializes and returns a new default snake with size 1 in position 0:0.
+ * @brief Initializes and returns a new default snake with size 1 in position 0:2.
  *
+ * @param[in] items Buffer used to store the body, at least one position.
+ * @param[in] capacity Number of positions of the buffer.
  * @return Snake A fully initialized snake structure.
  */
-Snake create_snake();
+Snake create_snake(vector2i *items, size_t capacity);
 
 /**
  * @brief Returns the size of the snake.
@@ -165,6 +176,9 @@ vector2i* get_snake_part_position(Snake *snake, size_t index);
 /**
  * @brief Founds a specific segment of the snake by position
  *
+ * When the snake is attached to an occupancy grid, this is a single cell
+ * lookup. Otherwise the body is scanned.
+ *
  * @param[in] snake Pointer.
  * @param[in] pos Position of segment.
  * @return index of a segment of the snake in this position
@@ -180,6 +194,35 @@ int find_snake_part_by_position(Snake *snake, vector2i pos);
  */
 vector2i* get_snake_head_position(Snake *snake);
 
+/**
+ * @brief Moves the head of the snake to a new position.
+ *
+ * Used for teleportation and wrapping around the grid borders. The occupancy
+ * grid is updated: the old head cell is released and the new one claimed.
+ *
+ * @param[out] snake Pointer.
+ * @param[in] pos New head position.
+ */
+void set_snake_head_position(Snake *snake, vector2i pos);
+
+/**
+ * @brief Attaches the snake to an occupancy grid and registers all its segments.
+ *
+ * @param[out] snake Pointer.
+ * @param[in,out] grid Occupancy grid to keep up to date.
+ * @param[in] id Owner id of the snake in the grid (must not be OCCUPANCY_NO_OWNER).
+ */
+void attach_snake_to_grid(Snake *snake, OccupancyGrid *grid, unsigned short id);
+
+/**
+ * @brief Removes all the segments of the snake from its occupancy grid.
+ *
+ * The snake is no longer attached to any grid afterwards.
+ *
+ * @param[out] snake Pointer.
+ */
+void detach_snake_from_grid(Snake *snake);
+
 /**
  * @brief Ensures that the back buffer never exceeds the maximum allowed space.
  *
@@ -209,6 +252,10 @@ void move_back_snake(Snake *snake);
 /**
  * @brief Moves the snake and grows it by one segment.
  *
+ * A snake only grows while SNAKE_ROLLBACK_SIZE positions stay free in
+ * its buffer, so that the moves of a tick can always be undone with
+ * move_back_snake(). A longer snake only moves.
+ *
  * @param[out] snake Pointer.
  */
 void move_and_expand_snake(Snake *snake);
@@ -240,13 +287,29 @@ void remove_tail_snake(Snake *snake);
 void set_snake_direction(Snake *snake, SnakeDirection direction);
 
 /**
- * @brief Changes the rendering color of the snake.
+ * @brief Queues a direction change for one of the next moves.
+ *
+ * The turn is checked against the last queued direction (or the current
+ * direction if the queue is empty): a reversal or a turn to the same
+ * direction is ignored, as well as any turn when the queue is full.
+ *
+ * @param[out] snake Pointer.
+ * @param[in] direction Desired direction.
+ * @param[in] time Time of the request, given back in turn_time when applied.
+ * @return int 1 if the turn was queued, 0 if it was ignored.
+ */
+int queue_snake_turn(Snake *snake, SnakeDirection direction, unsigned long time);
+
+/**
+ * @brief Takes the oldest queued turn as the direction of the next move.
  *
- * White and red are disallowed as playable colors for visibility reasons.
+ * Must be called once per game tick, before the snake moves. A queued
+ * turn which became a reversal (the direction was changed by
+ * set_snake_direction() meanwhile) is dropped.
  *
  * @param[out] snake Pointer.
- * @param[in] color New color to apply.
+ * @return int 1 if a turn was applied (snake->turn_time is then its request time), 0 otherwise.
  */
-void set_snake_color(Snake *snake, MLV_Color color);
+int apply_snake_turn(Snake *snake);
 
-void free_snake(Snake *snake);
\ No newline at end of file
+#endif /* _SNAKE_H */
@@ -0,0 +1,408 @@
+#include"skin_cache.h"
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<string.h>
+#include<pthread.h>
+
+#define SKINS_NUMBER ( MAX_SNAKE_SPRITE_INDEX + 1 )
+#define SKIN_CACHE_QUEUE_SIZE ( 2 * SKIN_CACHE_PREFETCH_DISTANCE )
+
+typedef enum {
+    SKIN_VARIANT_SPRITE = 0, /* images of the game */
+    SKIN_VARIANT_PREVIEW,    /* preview of the skin dialogs */
+    SKIN_VARIANTS_NUMBER
+} SKIN_VARIANT;
+
+typedef enum {
+    SKIN_ENTRY_EMPTY = 0, /* nothing decoded */
+    SKIN_ENTRY_LOADING,   /* decoded by a thread, without the lock */
+    SKIN_ENTRY_DECODED,   /* pixels of the preview copied by the loader, no image yet */
+    SKIN_ENTRY_READY      /* decoded */
+} SKIN_ENTRY_STATE;
+
+typedef struct {
+    SKIN_ENTRY_STATE states[SKIN_VARIANTS_NUMBER];
+    int references[SKIN_VARIANTS_NUMBER];
+    SnakeSprite sprite;
+    MLV_Image *preview;
+    uint32_t *preview_pixels; /* 0xRRGGBBAA, while the preview is SKIN_ENTRY_DECODED */
+    int preview_width;
+    int preview_height;
+    unsigned long last_use;
+} SkinEntry;
+
+typedef struct {
+    SkinEntry entries[SKINS_NUMBER];
+    unsigned long clock;     /* incremented at every acquire */
+
+    int queue[SKIN_CACHE_QUEUE_SIZE]; /* previews to prefetch, first one first */
+    int queue_count;
+
+    int initialized;         /* lock and conditions created */
+    int loader_running;      /* loader thread started */
+    int quit;                /* 1 when the loader must stop */
+    pthread_t loader;
+    pthread_mutex_t lock;    /* protects everything above and the entries */
+    pthread_cond_t wake;     /* signaled when a prefetch is asked or on quit */
+    pthread_cond_t loaded;   /* signaled when a variant leaves SKIN_ENTRY_LOADING */
+
+    unsigned long hits;
+    unsigned long decodes;   /* decoded by the main thread */
+    unsigned long prefetches;/* copied by the loader thread */
+    unsigned long waits;     /* main thread waited for the loader */
+    unsigned long evictions;
+} SkinCache;
+
+static SkinCache skin_cache;
+
+/*
+ * Frees the decoded variants of an entry. The variants being decoded
+ * are left to their thread. Called by the main thread only.
+ */
+static void free_skin_entry(SkinEntry *entry) {
+    if (entry->states[SKIN_VARIANT_SPRITE] == SKIN_ENTRY_READY) {
+        free_snake_sprite(&entry->sprite);
+        entry->states[SKIN_VARIANT_SPRITE] = SKIN_ENTRY_EMPTY;
+    }
+
+    if (entry->states[SKIN_VARIANT_PREVIEW] == SKIN_ENTRY_READY) {
+        MLV_free_image(entry->preview);
+        entry->preview = NULL;
+        entry->states[SKIN_VARIANT_PREVIEW] = SKIN_ENTRY_EMPTY;
+    } else if (entry->states[SKIN_VARIANT_PREVIEW] == SKIN_ENTRY_DECODED) {
+        free(entry->preview_pixels);
+        entry->preview_pixels = NULL;
+        entry->states[SKIN_VARIANT_PREVIEW] = SKIN_ENTRY_EMPTY;
+    }
+}
+
+/*
+ * Returns 1 if an entry holds a decoded variant and no reference.
+ */
+static int is_unused_skin_entry(const SkinEntry *entry) {
+    return (entry->states[SKIN_VARIANT_SPRITE] == SKIN_ENTRY_READY ||
+            entry->states[SKIN_VARIANT_PREVIEW] == SKIN_ENTRY_READY ||
+            entry->states[SKIN_VARIANT_PREVIEW] == SKIN_ENTRY_DECODED) &&
+           entry->references[SKIN_VARIANT_SPRITE] == 0 &&
+           entry->references[SKIN_VARIANT_PREVIEW] == 0;
+}
+
+/*
+ * Frees the least recently used skins without reference past
+ * SKIN_CACHE_MAX_UNUSED. Called by the main thread, with the lock.
+ */
+static void evict_unused_skins() {
+    SkinEntry *entry, *victim;
+    int i, unused;
+
+    do {
+        unused = 0;
+        victim = NULL;
+
+        for (i = 0; i < SKINS_NUMBER; i++) {
+            entry = &skin_cache.entries[i];
+
+            if (is_unused_skin_entry(entry)) {
+                unused++;
+                if (victim == NULL || entry->last_use < victim->last_use)
+                    victim = entry;
+            }
+        }
+
+        if (unused > SKIN_CACHE_MAX_UNUSED) {
+            free_skin_entry(victim);
+            skin_cache.evictions++;
+        }
+    } while (unused > SKIN_CACHE_MAX_UNUSED);
+}
+
+/*
+ * Decodes an empty variant without the lock and stores it.
+ * Called by the main thread, with the lock, which is released during
+ * the decoding.
+ */
+static void decode_skin_variant(int index, SKIN_VARIANT variant) {
+    SkinEntry *entry;
+    SnakeSprite sprite;
+    MLV_Image *preview;
+    int decoded;
+
+    entry = &skin_cache.entries[index];
+    entry->states[variant] = SKIN_ENTRY_LOADING;
+
+    pthread_mutex_unlock(&skin_cache.lock);
+
+    if (variant == SKIN_VARIANT_SPRITE) {
+        decoded = load_snake_sprite_images(&sprite, index);
+    } else {
+        preview = load_snake_preview(index, SKIN_PREVIEW_SIZE);
+        decoded = preview != NULL;
+    }
+
+    pthread_mutex_lock(&skin_cache.lock);
+
+    if (decoded && variant == SKIN_VARIANT_SPRITE)
+        entry->sprite = sprite;
+    else if (decoded)
+        entry->preview = preview;
+
+    entry->states[variant] = decoded ? SKIN_ENTRY_READY : SKIN_ENTRY_EMPTY;
+    entry->last_use = skin_cache.clock;
+
+    evict_unused_skins();
+}
+
+/*
+ * Returns a copy of the pixels of the preview of a skin in the bundle,
+ * NULL if the bundle has no preview of SKIN_PREVIEW_SIZE. Calls no MLV
+ * function, so the loader thread can use it.
+ */
+static uint32_t* copy_bundle_preview(int index, int *width, int *height) {
+    const AssetBundle *bundle;
+    const uint32_t *pixels;
+    uint32_t *res;
+
+    bundle = get_game_assets();
+    pixels = NULL;
+    res = NULL;
+
+    if (bundle != NULL && bundle->header->preview_size == SKIN_PREVIEW_SIZE)
+        pixels = get_asset_pixels(bundle, get_asset_id(ASSET_SNAKE_PREVIEW, index, 0), width, height);
+
+    if (pixels != NULL)
+        res = malloc(*width * *height * sizeof(uint32_t));
+
+    if (res != NULL)
+        memcpy(res, pixels, *width * *height * sizeof(uint32_t));
+
+    return res;
+}
+
+/*
+ * Copies the pixels of an empty preview without the lock, leaving the
+ * entry SKIN_ENTRY_DECODED. Called by the loader thread, with the lock,
+ * which is released during the copy.
+ */
+static void prefetch_skin_preview(int index) {
+    SkinEntry *entry;
+    uint32_t *pixels;
+    int width, height;
+
+    entry = &skin_cache.entries[index];
+    entry->states[SKIN_VARIANT_PREVIEW] = SKIN_ENTRY_LOADING;
+
+    pthread_mutex_unlock(&skin_cache.lock);
+    pixels = copy_bundle_preview(index, &width, &height);
+    pthread_mutex_lock(&skin_cache.lock);
+
+    if (pixels != NULL) {
+        entry->preview_pixels = pixels;
+        entry->preview_width = width;
+        entry->preview_height = height;
+    }
+
+    entry->states[SKIN_VARIANT_PREVIEW] = pixels != NULL ? SKIN_ENTRY_DECODED : SKIN_ENTRY_EMPTY;
+    entry->last_use = skin_cache.clock;
+
+    pthread_cond_broadcast(&skin_cache.loaded);
+}
+
+static void* run_skin_loader(void *data) {
+    int index;
+
+    (void) data;
+
+    pthread_mutex_lock(&skin_cache.lock);
+
+    while (!skin_cache.quit) {
+        if (skin_cache.queue_count == 0) {
+            pthread_cond_wait(&skin_cache.wake, &skin_cache.lock);
+        } else {
+            index = skin_cache.queue[0];
+            skin_cache.queue_count--;
+            memmove(skin_cache.queue, skin_cache.queue + 1, skin_cache.queue_count * sizeof(int));
+
+            if (skin_cache.entries[index].states[SKIN_VARIANT_PREVIEW] == SKIN_ENTRY_EMPTY) {
+                prefetch_skin_preview(index);
+                skin_cache.prefetches++;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&skin_cache.lock);
+
+    return NULL;
+}
+
+/*
+ * Creates the lock and the conditions at the first use of the cache.
+ */
+static void init_skin_cache() {
+    int i, j;
+
+    if (!skin_cache.initialized) {
+        pthread_mutex_init(&skin_cache.lock, NULL);
+        pthread_cond_init(&skin_cache.wake, NULL);
+        pthread_cond_init(&skin_cache.loaded, NULL);
+
+        for (i = 0; i < SKINS_NUMBER; i++) {
+            for (j = 0; j < SKIN_VARIANTS_NUMBER; j++) {
+                skin_cache.entries[i].states[j] = SKIN_ENTRY_EMPTY;
+                skin_cache.entries[i].references[j] = 0;
+            }
+            skin_cache.entries[i].preview = NULL;
+            skin_cache.entries[i].preview_pixels = NULL;
+        }
+
+        skin_cache.queue_count = 0;
+        skin_cache.loader_running = 0;
+        skin_cache.quit = 0;
+        skin_cache.initialized = 1;
+
+        /* the bundle is opened by the main thread, the loader only reads it */
+        get_game_assets();
+    }
+}
+
+/*
+ * Borrows a variant of a skin, decoded by the main thread or waited for
+ * if needed. Returns the entry of the skin.
+ */
+static SkinEntry* acquire_skin_variant(int index, SKIN_VARIANT variant) {
+    SkinEntry *res;
+
+    init_skin_cache();
+    pthread_mutex_lock(&skin_cache.lock);
+
+    res = &skin_cache.entries[index];
+    skin_cache.clock++;
+
+    if (res->states[variant] == SKIN_ENTRY_READY || res->states[variant] == SKIN_ENTRY_DECODED) {
+        skin_cache.hits++;
+    } else if (res->states[variant] == SKIN_ENTRY_LOADING) {
+        skin_cache.waits++;
+        while (res->states[variant] == SKIN_ENTRY_LOADING)
+            pthread_cond_wait(&skin_cache.loaded, &skin_cache.lock);
+    }
+
+    /* copied by the loader: the image is created here, on the main thread */
+    if (res->states[variant] == SKIN_ENTRY_DECODED) {
+        res->preview = create_pixels_image(res->preview_pixels, res->preview_width, res->preview_height);
+        free(res->preview_pixels);
+        res->preview_pixels = NULL;
+        res->states[variant] = res->preview != NULL ? SKIN_ENTRY_READY : SKIN_ENTRY_EMPTY;
+    }
+
+    /* nobody decoded it, or the loader failed */
+    if (res->states[variant] == SKIN_ENTRY_EMPTY) {
+        skin_cache.decodes++;
+        decode_skin_variant(index, variant);
+    }
+
+    if (res->states[variant] != SKIN_ENTRY_READY) {
+        fprintf(stderr, "Error : snake sprite not found\n");
+        exit(EXIT_FAILURE);
+    }
+
+    res->references[variant]++;
+    res->last_use = skin_cache.clock;
+
+    pthread_mutex_unlock(&skin_cache.lock);
+
+    return res;
+}
+
+static void release_skin_variant(int index, SKIN_VARIANT variant) {
+    pthread_mutex_lock(&skin_cache.lock);
+
+    skin_cache.entries[index].references[variant]--;
+    evict_unused_skins();
+
+    pthread_mutex_unlock(&skin_cache.lock);
+}
+
+/*
+ * Returns the index of a skin, 0 with a warning if it is out of bounds.
+ */
+static int check_skin_index(int index) {
+    if (index < 0 || index > MAX_SNAKE_SPRITE_INDEX) {
+        fprintf(stderr, "Warining : snake sprite index %d out of bounds\nset sprite index to 0\n", index);
+        index = 0;
+    }
+
+    return index;
+}
+
+const SnakeSprite* acquire_skin_sprite(int index) {
+    return &acquire_skin_variant(check_skin_index(index), SKIN_VARIANT_SPRITE)->sprite;
+}
+
+void release_skin_sprite(int index) {
+    release_skin_variant(check_skin_index(index), SKIN_VARIANT_SPRITE);
+}
+
+MLV_Image* acquire_skin_preview(int index) {
+    return acquire_skin_variant(check_skin_index(index), SKIN_VARIANT_PREVIEW)->preview;
+}
+
+void release_skin_preview(int index) {
+    release_skin_variant(check_skin_index(index), SKIN_VARIANT_PREVIEW);
+}
+
+void prefetch_skins(int index) {
+    int distance, side, neighbour;
+
+    init_skin_cache();
+    pthread_mutex_lock(&skin_cache.lock);
+
+    /* without loader thread, the skins are decoded when acquired: the
+       loader only copies bundle pixels, a PNG needs MLV to be decoded */
+    if (!skin_cache.loader_running && !skin_cache.quit && get_game_assets() != NULL &&
+        get_game_assets()->header->preview_size == SKIN_PREVIEW_SIZE)
+        skin_cache.loader_running = pthread_create(&skin_cache.loader, NULL, run_skin_loader, NULL) == 0;
+
+    /* nearest first, the previous requests are outdated */
+    skin_cache.queue_count = 0;
+    for (distance = 1; distance <= SKIN_CACHE_PREFETCH_DISTANCE; distance++) {
+        for (side = 1; side >= -1; side -= 2) {
+            neighbour = ((index + side * distance) % SKINS_NUMBER + SKINS_NUMBER) % SKINS_NUMBER;
+
+            if (skin_cache.entries[neighbour].states[SKIN_VARIANT_PREVIEW] == SKIN_ENTRY_EMPTY)
+                skin_cache.queue[skin_cache.queue_count++] = neighbour;
+        }
+    }
+
+    if (skin_cache.loader_running)
+        pthread_cond_signal(&skin_cache.wake);
+
+    pthread_mutex_unlock(&skin_cache.lock);
+}
+
+void free_skin_cache() {
+    int i;
+
+    if (skin_cache.initialized) {
+        pthread_mutex_lock(&skin_cache.lock);
+        skin_cache.quit = 1;
+        pthread_cond_signal(&skin_cache.wake);
+        pthread_mutex_unlock(&skin_cache.lock);
+
+        if (skin_cache.loader_running)
+            pthread_join(skin_cache.loader, NULL);
+
+        for (i = 0; i < SKINS_NUMBER; i++)
+            free_skin_entry(&skin_cache.entries[i]);
+
+        pthread_mutex_destroy(&skin_cache.lock);
+        pthread_cond_destroy(&skin_cache.wake);
+        pthread_cond_destroy(&skin_cache.loaded);
+        skin_cache.initialized = 0;
+    }
+}
+
+void print_skin_cache_report() {
+    printf("skin cache: %lu hits, %lu decoded, %lu prefetched, %lu waits, %lu evictions\n",
+           skin_cache.hits, skin_cache.decodes, skin_cache.prefetches,
+           skin_cache.waits, skin_cache.evictions);
+}
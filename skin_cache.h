@@ -0,0 +1,104 @@
+/**
+ * @file skin_cache.h
+ * @brief Process-wide cache of the snake skins.
+ *
+ * A skin has two variants: the SnakeSprite drawn in the game (every part
+ * at the size of a grid cell, in every orientation) and the
+ * SKIN_PREVIEW_SIZE preview of the skin dialogs. Each one is decoded
+ * once, when it is first needed, from the asset bundle or else from the
+ * sprite sheet, and kept under the index of the skin.
+ *
+ * ## References
+ * A variant is borrowed with acquire_skin_sprite() or
+ * acquire_skin_preview() and given back with the matching release
+ * function. A skin with references is never freed. Up to
+ * SKIN_CACHE_MAX_UNUSED skins without reference are kept for later, the
+ * least recently used ones are freed past this number.
+ *
+ * ## Preloading
+ * prefetch_skins() asks a loader thread to copy the previews around an
+ * index (the neighbours of the carousel of the skin dialogs) out of the
+ * asset bundle, so the next arrow click finds its pixels in memory. When
+ * the main thread needs a skin being copied by the loader, it waits for
+ * it; when nobody copied it, the main thread decodes it itself.
+ *
+ * MLV does not document its image functions as thread-safe, so the
+ * loader thread never calls MLV: it only fills plain 0xRRGGBBAA buffers,
+ * and the MLV_Image of a preview is created from them by the main thread
+ * in acquire_skin_preview(). Every image is also freed by the main
+ * thread. Without a bundle holding SKIN_PREVIEW_SIZE previews, no loader
+ * is started and the PNG files are decoded by the main thread when
+ * acquired.
+ */
+
+#ifndef _SKIN_CACHE_H
+#define _SKIN_CACHE_H
+
+#include<MLV/MLV_all.h>
+
+#include"game_view.h"
+
+#define SKIN_PREVIEW_SIZE 512          /**< Side of the preview variant in pixels */
+#define SKIN_CACHE_MAX_UNUSED 8        /**< Skins without reference kept decoded */
+#define SKIN_CACHE_PREFETCH_DISTANCE 2 /**< Neighbours prefetched on each side of a skin */
+
+/**
+ * @brief Borrows the game variant of a skin, decoded if needed.
+ *
+ * Exits the program if the sprite sheet cannot be loaded.
+ *
+ * @param[in] index Index of the skin (0 to MAX_SNAKE_SPRITE_INDEX).
+ * @return const SnakeSprite* Images of the skin, owned by the cache and
+ *         valid until release_skin_sprite().
+ */
+const SnakeSprite* acquire_skin_sprite(int index);
+
+/**
+ * @brief Gives back the game variant of a skin.
+ *
+ * @param[in] index Index of the skin.
+ */
+void release_skin_sprite(int index);
+
+/**
+ * @brief Borrows the preview variant of a skin, decoded if needed.
+ *
+ * Exits the program if the sprite sheet cannot be loaded.
+ *
+ * @param[in] index Index of the skin (0 to MAX_SNAKE_SPRITE_INDEX).
+ * @return MLV_Image* Sprite sheet resized to SKIN_PREVIEW_SIZE, owned by
+ *         the cache and valid until release_skin_preview().
+ */
+MLV_Image* acquire_skin_preview(int index);
+
+/**
+ * @brief Gives back the preview variant of a skin.
+ *
+ * @param[in] index Index of the skin.
+ */
+void release_skin_preview(int index);
+
+/**
+ * @brief Asks the loader thread to copy the previews of the neighbours of a skin.
+ *
+ * The skins up to SKIN_CACHE_PREFETCH_DISTANCE indexes away on each side
+ * (wrapping around like the carousel) replace the previous requests.
+ *
+ * @param[in] index Index of the skin shown.
+ */
+void prefetch_skins(int index);
+
+/**
+ * @brief Stops the loader thread and frees every skin.
+ *
+ * No variant may be borrowed any more. The cache can be used again
+ * afterwards.
+ */
+void free_skin_cache();
+
+/**
+ * @brief Prints the hits, decodes, waits and evictions of the cache.
+ */
+void print_skin_cache_report();
+
+#endif /* _SKIN_CACHE_H */
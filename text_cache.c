@@ -0,0 +1,198 @@
+#include"text_cache.h"
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<string.h>
+
+/*
+ * Everything which changes the pixels of a rendered text.
+ */
+typedef struct {
+    char *text;
+    const MLV_Font *font;
+    TEXT_STYLE style;
+    MLV_Color color;
+    MLV_Color border_color;     /* TEXT_STYLE_BOX only */
+    MLV_Color background_color; /* TEXT_STYLE_BOX only */
+    int width, height, spacing; /* TEXT_STYLE_BOX only */
+} TextKey;
+
+typedef struct {
+    TextKey key;
+    MLV_Image *image;      /* NULL if the entry is free */
+    unsigned long last_use;
+} TextEntry;
+
+typedef struct {
+    TextEntry entries[TEXT_CACHE_SIZE];
+    unsigned long clock;   /* incremented at every use of an entry */
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+} TextCache;
+
+static TextCache text_cache;
+
+static int is_same_text_key(const TextKey *a, const TextKey *b) {
+    return a->font == b->font && a->style == b->style && a->color == b->color &&
+           a->border_color == b->border_color && a->background_color == b->background_color &&
+           a->width == b->width && a->height == b->height && a->spacing == b->spacing &&
+           strcmp(a->text, b->text) == 0;
+}
+
+static void free_text_entry(TextEntry *entry) {
+    if (entry->image != NULL) {
+        MLV_free_image(entry->image);
+        free(entry->key.text);
+
+        entry->image = NULL;
+        entry->key.text = NULL;
+    }
+}
+
+/*
+ * Renders the text of a key in a new image.
+ */
+static MLV_Image* render_text_image(const TextKey *key) {
+    MLV_Image *res;
+    int width, height, o;
+
+    if (key->style == TEXT_STYLE_BOX) {
+        res = MLV_create_image(key->width, key->height);
+
+        if (res != NULL)
+            MLV_draw_text_box_with_font_on_image(0, 0, key->width, key->height,
+                                                 "%s", key->font, key->spacing,
+                                                 key->border_color, key->color, key->background_color,
+                                                 MLV_TEXT_CENTER, MLV_HORIZONTAL_CENTER, MLV_VERTICAL_CENTER,
+                                                 res, key->text);
+    } else {
+        MLV_get_size_of_text_with_font("%s", &width, &height, key->font, key->text);
+
+        o = key->style == TEXT_STYLE_OUTLINE ? TEXT_OUTLINE_SIZE : 0;
+        res = MLV_create_image(width + 2 * o, height + 2 * o);
+
+        if (res != NULL && key->style == TEXT_STYLE_OUTLINE) {
+            MLV_draw_text_with_font_on_image(0, o, "%s", key->font, MLV_COLOR_BLACK, res, key->text);
+            MLV_draw_text_with_font_on_image(2 * o, o, "%s", key->font, MLV_COLOR_BLACK, res, key->text);
+            MLV_draw_text_with_font_on_image(o, 0, "%s", key->font, MLV_COLOR_BLACK, res, key->text);
+            MLV_draw_text_with_font_on_image(o, 2 * o, "%s", key->font, MLV_COLOR_BLACK, res, key->text);
+        }
+
+        if (res != NULL)
+            MLV_draw_text_with_font_on_image(o, o, "%s", key->font, key->color, res, key->text);
+    }
+
+    return res;
+}
+
+/*
+ * Returns the image of a key: the one of the cache, or a new one which
+ * replaces a free or the least recently used entry.
+ */
+static MLV_Image* get_cached_text_image(const TextKey *key) {
+    TextEntry *entry, *victim;
+    MLV_Image *res;
+    int i;
+
+    text_cache.clock++;
+
+    entry = NULL;
+    victim = &text_cache.entries[0];
+
+    for (i = 0; i < TEXT_CACHE_SIZE && entry == NULL; i++) {
+        if (text_cache.entries[i].image == NULL) {
+            if (victim->image != NULL)
+                victim = &text_cache.entries[i];
+        } else if (is_same_text_key(&text_cache.entries[i].key, key)) {
+            entry = &text_cache.entries[i];
+        } else if (victim->image != NULL && text_cache.entries[i].last_use < victim->last_use) {
+            victim = &text_cache.entries[i];
+        }
+    }
+
+    if (entry != NULL) {
+        text_cache.hits++;
+        entry->last_use = text_cache.clock;
+        res = entry->image;
+    } else {
+        text_cache.misses++;
+        if (victim->image != NULL)
+            text_cache.evictions++;
+        free_text_entry(victim);
+
+        victim->key = *key;
+        victim->key.text = (char*) malloc(strlen(key->text) + 1);
+        res = NULL;
+
+        if (victim->key.text != NULL) {
+            strcpy(victim->key.text, key->text);
+            res = render_text_image(key);
+        }
+
+        if (res == NULL) {
+            free(victim->key.text);
+            victim->key.text = NULL;
+        } else {
+            victim->image = res;
+            victim->last_use = text_cache.clock;
+        }
+    }
+
+    return res;
+}
+
+MLV_Image* get_text_image(const char *text, const MLV_Font *font, MLV_Color color, TEXT_STYLE style) {
+    TextKey key;
+
+    key.text = (char*) text;
+    key.font = font;
+    key.style = style;
+    key.color = color;
+    key.border_color = 0;
+    key.background_color = 0;
+    key.width = 0;
+    key.height = 0;
+    key.spacing = 0;
+
+    return get_cached_text_image(&key);
+}
+
+MLV_Image* get_text_box_image(const char *text, const MLV_Font *font,
+                              int width, int height, int spacing,
+                              MLV_Color border_color, MLV_Color text_color, MLV_Color background_color) {
+    TextKey key;
+
+    key.text = (char*) text;
+    key.font = font;
+    key.style = TEXT_STYLE_BOX;
+    key.color = text_color;
+    key.border_color = border_color;
+    key.background_color = background_color;
+    key.width = width;
+    key.height = height;
+    key.spacing = spacing;
+
+    return get_cached_text_image(&key);
+}
+
+void forget_font_texts(const MLV_Font *font) {
+    int i;
+
+    for (i = 0; i < TEXT_CACHE_SIZE; i++) {
+        if (text_cache.entries[i].image != NULL && text_cache.entries[i].key.font == font)
+            free_text_entry(&text_cache.entries[i]);
+    }
+}
+
+void free_text_cache() {
+    int i;
+
+    for (i = 0; i < TEXT_CACHE_SIZE; i++)
+        free_text_entry(&text_cache.entries[i]);
+}
+
+void print_text_cache_report() {
+    printf("text cache: %lu hits, %lu misses, %lu evictions\n",
+           text_cache.hits, text_cache.misses, text_cache.evictions);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file text_cache.h
+ * @brief Cache of rendered texts.
+ *
+ * Rasterizing a text with a TTF font, or laying out a text box, costs far
+ * more than drawing an image. A text is rendered once in an MLV_Image,
+ * kept in the cache under its key (text, font, colors, style and box
+ * size) and the image is drawn every frame until the key changes.
+ *
+ * The cache holds at most TEXT_CACHE_SIZE images. When it is full, the
+ * least recently used one is freed to make room for a new text.
+ *
+ * The fonts are compared by address: the texts of a font must be
+ * forgotten (forget_font_texts()) before the font is freed.
+ */
+
+#ifndef _TEXT_CACHE_H
+#define _TEXT_CACHE_H
+
+#include<MLV/MLV_all.h>
+
+#define TEXT_CACHE_SIZE 32 /**< Maximum number of rendered texts kept */
+#define TEXT_OUTLINE_SIZE 2 /**< Width of the outline of TEXT_STYLE_OUTLINE in pixels */
+
+/**
+ * @enum TEXT_STYLE
+ * @brief How a text is rendered.
+ */
+typedef enum {
+    TEXT_STYLE_PLAIN = 0, /**< The text alone, on a transparent image */
+    TEXT_STYLE_OUTLINE,   /**< The text over a black outline of TEXT_OUTLINE_SIZE pixels, on a transparent image */
+    TEXT_STYLE_BOX        /**< The text centered in a box (MLV_draw_text_box_with_font) */
+} TEXT_STYLE;
+
+/**
+ * @brief Returns the image of a text, rendered if it is not in the cache.
+ *
+ * The image of TEXT_STYLE_OUTLINE is larger than the text by
+ * TEXT_OUTLINE_SIZE pixels on every side.
+ *
+ * @param[in] text Text to render.
+ * @param[in] font Font of the text.
+ * @param[in] color Color of the text.
+ * @param[in] style TEXT_STYLE_PLAIN or TEXT_STYLE_OUTLINE.
+ * @return MLV_Image* Image owned by the cache, valid until the next call
+ *         of a function of the cache. NULL if it could not be rendered.
+ */
+MLV_Image* get_text_image(const char *text, const MLV_Font *font, MLV_Color color, TEXT_STYLE style);
+
+/**
+ * @brief Returns the image of a text box, rendered if it is not in the cache.
+ *
+ * The text is centered in the box, as drawn by MLV_draw_text_box_with_font()
+ * with MLV_TEXT_CENTER, MLV_HORIZONTAL_CENTER and MLV_VERTICAL_CENTER.
+ *
+ * @param[in] text Text of the box.
+ * @param[in] font Font of the text.
+ * @param[in] width Width of the box in pixels.
+ * @param[in] height Height of the box in pixels.
+ * @param[in] spacing Space between the lines of the text.
+ * @param[in] border_color Color of the border of the box.
+ * @param[in] text_color Color of the text.
+ * @param[in] background_color Color of the box.
+ * @return MLV_Image* Image owned by the cache, valid until the next call
+ *         of a function of the cache. NULL if it could not be rendered.
+ */
+MLV_Image* get_text_box_image(const char *text, const MLV_Font *font,
+                              int width, int height, int spacing,
+                              MLV_Color border_color, MLV_Color text_color, MLV_Color background_color);
+
+/**
+ * @brief Frees the images of the texts rendered with a font.
+ *
+ * @param[in] font Font about to be freed.
+ */
+void forget_font_texts(const MLV_Font *font);
+
+/**
+ * @brief Frees all the images of the cache.
+ */
+void free_text_cache();
+
+/**
+ * @brief Prints the hits, misses and evictions of the cache.
+ */
+void print_text_cache_report();
+
+#endif /* _TEXT_CACHE_H */
@@ -0,0 +1,143 @@
+/**
+ * @file asset_bake.c
+ * @brief Bakes the asset bundle of the game (asset_bundle.h).
+ *
+ * Every skin is decoded, cut and oriented by create_snake_sprite(), its
+ * preview resized to SKIN_PREVIEW_SIZE, and the apple resized to a grid
+ * cell: the very code the game runs without bundle, so the images of the
+ * bundle are the same pixels. They are written for GRID_CELL_DRAW_SIZE;
+ * the bundle must be baked again when the cell size changes.
+ *
+ * MLV needs a window to load images: a small one is opened while baking.
+ *
+ * Usage: ./tools/asset_bake [bundle path]
+ */
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<time.h>
+#include<MLV/MLV_all.h>
+
+#include"asset_bundle.h"
+#include"game_view.h"
+#include"skin_cache.h"
+
+/* every part of every skin, its preview and the apple */
+#define BAKE_MAX_IMAGES ( ( MAX_SNAKE_SPRITE_INDEX + 1 ) * \
+                          ( 3 * SPRITE_ORIENTATIONS_NUMBER + SPRITE_MIRRORS_NUMBER + 1 ) + 1 )
+
+/*
+ * Copies the pixels of an image in the next image of the bundle.
+ */
+static void add_bake_image(AssetImage *images, int *count, MLV_Image *source,
+                           ASSET_KIND kind, int skin, int variant) {
+    AssetImage *image;
+    uint32_t *pixels;
+    int x, y, r, g, b, a;
+
+    image = &images[*count];
+    MLV_get_image_size(source, &image->width, &image->height);
+
+    pixels = (uint32_t*) malloc((size_t) image->width * image->height * sizeof(uint32_t));
+    if (pixels == NULL) {
+        fprintf(stderr, "Error asset_bake: can't allocate the pixels\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (y = 0; y < image->height; y++) {
+        for (x = 0; x < image->width; x++) {
+            MLV_get_pixel_on_image(source, x, y, &r, &g, &b, &a);
+            pixels[y * image->width + x] = ((uint32_t) r << 24) | ((uint32_t) g << 16) |
+                                           ((uint32_t) b << 8) | (uint32_t) a;
+        }
+    }
+
+    image->id = get_asset_id(kind, skin, variant);
+    image->pixels = pixels;
+    (*count)++;
+}
+
+/*
+ * Adds the game images and the preview of a skin.
+ */
+static void add_bake_skin(AssetImage *images, int *count, int index) {
+    SnakeSprite sprite;
+    MLV_Image *sheet;
+    char path[SNAKE_SPRITE_PATH_SIZE];
+    int i;
+
+    get_snake_sprite_path(index, path);
+    sheet = MLV_load_image(path);
+    if (sheet == NULL) {
+        fprintf(stderr, "Error asset_bake: can't load %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    create_snake_sprite(&sprite, sheet);
+
+    for (i = 0; i < SPRITE_ORIENTATIONS_NUMBER; i++) {
+        add_bake_image(images, count, sprite.head[i], ASSET_SNAKE_HEAD, index, i);
+        add_bake_image(images, count, sprite.tail[i], ASSET_SNAKE_TAIL, index, i);
+        add_bake_image(images, count, sprite.straight_body[i], ASSET_SNAKE_STRAIGHT_BODY, index, i);
+    }
+    for (i = 0; i < SPRITE_MIRRORS_NUMBER; i++)
+        add_bake_image(images, count, sprite.rotate_body[i], ASSET_SNAKE_ROTATE_BODY, index, i);
+
+    MLV_resize_image_with_proportions(sheet, SKIN_PREVIEW_SIZE, SKIN_PREVIEW_SIZE);
+    add_bake_image(images, count, sheet, ASSET_SNAKE_PREVIEW, index, 0);
+
+    free_snake_sprite(&sprite);
+    MLV_free_image(sheet);
+}
+
+int main(int argc, char **argv) {
+    AssetImage *images;
+    MLV_Image *apple;
+    const char *path;
+    clock_t start;
+    long bytes;
+    int count, i;
+
+    path = argc > 1 ? argv[1] : ASSET_BUNDLE_PATH;
+
+    images = (AssetImage*) malloc(BAKE_MAX_IMAGES * sizeof(AssetImage));
+    if (images == NULL) {
+        fprintf(stderr, "Error asset_bake: can't allocate the images\n");
+        exit(EXIT_FAILURE);
+    }
+
+    MLV_create_window("asset_bake", "asset_bake", 64, 64);
+
+    start = clock();
+    count = 0;
+
+    for (i = 0; i <= MAX_SNAKE_SPRITE_INDEX; i++)
+        add_bake_skin(images, &count, i);
+
+    apple = save_sprite_load(APPLE_SPRITE_PATH);
+    if (apple == NULL) {
+        fprintf(stderr, "Error asset_bake: can't load %s\n", APPLE_SPRITE_PATH);
+        exit(EXIT_FAILURE);
+    }
+    add_bake_image(images, &count, apple, ASSET_APPLE, 0, 0);
+    MLV_free_image(apple);
+
+    if (!write_asset_bundle(path, GRID_CELL_DRAW_SIZE, SKIN_PREVIEW_SIZE, images, count)) {
+        fprintf(stderr, "Error asset_bake: can't write %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    bytes = 0;
+    for (i = 0; i < count; i++) {
+        bytes += (long) images[i].width * images[i].height * sizeof(uint32_t);
+        free((void*) images[i].pixels);
+    }
+    free(images);
+
+    printf("%s: %d images, %ld bytes of pixels, cells of %d pixels, baked in %.1f ms\n",
+           path, count, bytes, GRID_CELL_DRAW_SIZE, (double) (clock() - start) * 1e3 / CLOCKS_PER_SEC);
+
+    MLV_free_window();
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,131 @@
+/**
+ * @file render_capture.c
+ * @brief Plays a seeded game headless and captures its frames.
+ *
+ * The snake is played by the bot (game_bot.h) and every frame is drawn
+ * by draw_game() through the framebuffer output strategy
+ * (framebuffer_output.h) instead of the window: the same damage tracking
+ * and layers as in the game, painted in memory. CAPTURE_FRAMES_PER_TICK
+ * frames are drawn per tick, with the snakes shifted between two cells
+ * as in the game. The first frame of every CAPTURE_SAVE_EVERY ticks and
+ * the last frame are saved as PPM files, and the CPU time of draw_game()
+ * per frame is printed. The same seed gives the same frames.
+ *
+ * MLV needs a window to load images and draw texts: a small one is
+ * opened while capturing, nothing is painted on it.
+ *
+ * Usage: ./tools/render_capture [seed] [max ticks] [file prefix]
+ */
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<time.h>
+#include<MLV/MLV_all.h>
+
+#include"game_screen.h"
+#include"game_view.h"
+#include"skin_cache.h"
+#include"game_bot.h"
+#include"game_update.h"
+#include"framebuffer/framebuffer_output.h"
+
+#define CAPTURE_FRAMES_PER_TICK 4 /* frames drawn between two ticks */
+#define CAPTURE_SAVE_EVERY 10     /* ticks between two saved frames */
+#define CAPTURE_PATH_SIZE 256
+
+/*
+ * Saves the frame of the framebuffer as <prefix><tick>.ppm.
+ * Exits the program if it can't be written.
+ */
+static void save_capture_frame(const Framebuffer *framebuffer, const char *prefix, unsigned long tick) {
+    char path[CAPTURE_PATH_SIZE];
+
+    sprintf(path, "%.200s%05lu.ppm", prefix, tick);
+
+    if (!save_framebuffer_ppm(framebuffer, path)) {
+        fprintf(stderr, "Error render_capture: can't write %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+int main(int argc, char **argv) {
+    GameConfig config;
+    GameView view;
+    GameScreen screen;
+    Framebuffer framebuffer;
+    OutputStrategy output;
+    unsigned int score_list[GAME_SCORE_LIST_SIZE];
+    unsigned long seed, max_ticks, tick, saved;
+    const char *prefix;
+    clock_t start, draw_time;
+    int i;
+
+    seed = argc > 1 ? strtoul(argv[1], NULL, 10) : 1;
+    max_ticks = argc > 2 ? strtoul(argv[2], NULL, 10) : 200;
+    prefix = argc > 3 ? argv[3] : "capture_";
+
+    MLV_create_window("render_capture", "render_capture", 64, 64);
+
+    if (!init_framebuffer(&framebuffer, SCREEN_WIDTH, SCREEN_HEIGH)) {
+        fprintf(stderr, "Error render_capture: can't allocate the framebuffer\n");
+        exit(EXIT_FAILURE);
+    }
+    init_framebuffer_output(&output, &framebuffer);
+    set_output_strategy(&output);
+
+    if (!init_game(&config, GAME_SINGLE_PLAYER_MODE, GRID_SIZE, GRID_SIZE, seed)) {
+        fprintf(stderr, "Error render_capture: can't create the game\n");
+        exit(EXIT_FAILURE);
+    }
+
+    init_game_view(&view);
+    load_game_view(&view, &config);
+    init_game_screen_layers(&screen);
+
+    for (i = 0; i < GAME_SCORE_LIST_SIZE; i++)
+        score_list[i] = 0;
+
+    draw_time = 0;
+    saved = 0;
+
+    for (tick = 0; tick < max_ticks && config.snakes[0].is_alive && !config.board_full; tick++) {
+        update_bot(&config, &config.snakes[0]);
+        update_game(&config);
+
+        for (i = 0; i < CAPTURE_FRAMES_PER_TICK; i++) {
+            start = clock();
+            draw_game(&config, &view, &screen, score_list, (float) i / CAPTURE_FRAMES_PER_TICK);
+            draw_time += clock() - start;
+
+            if (i == 0 && tick % CAPTURE_SAVE_EVERY == 0) {
+                save_capture_frame(&framebuffer, prefix, tick);
+                saved++;
+            }
+        }
+    }
+
+    /* last frame, named after the number of ticks played */
+    if (tick > 0) {
+        save_capture_frame(&framebuffer, prefix, tick);
+        saved++;
+    }
+
+    printf("seed %lu: %lu ticks, score %u, %lu frames, %.3f ms of draw_game per frame, %lu frames saved as %s*.ppm\n",
+           seed, tick, config.score, framebuffer.frames,
+           framebuffer.frames > 0 ? (double) draw_time * 1e3 / CLOCKS_PER_SEC / framebuffer.frames : 0.0,
+           saved, prefix);
+
+    /* the images are forgotten by the framebuffer while it is current */
+    free_game_view(&view);
+    free_skin_cache();
+    free_game_screen_layers(&screen);
+    free_game_assets();
+    free_game(&config);
+
+    set_output_strategy(NULL);
+    free_framebuffer(&framebuffer);
+
+    MLV_free_window();
+
+    return EXIT_SUCCESS;
+}